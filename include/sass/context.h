@@ -14,6 +14,7 @@ extern "C" {
 
 // Forward declaration
 struct Sass_Compiler;
+struct Sass_Compiler_Pool;
 
 // Forward declaration
 struct Sass_Options; // base struct
@@ -21,6 +22,9 @@ struct Sass_Context; // : Sass_Options
 struct Sass_File_Context; // : Sass_Context
 struct Sass_Data_Context; // : Sass_Context
 
+// Receives the css output in chunks while it is generated
+typedef void (*Sass_Output_Writer) (const char* data, size_t length, void* cookie);
+
 // Compiler states
 enum Sass_Compiler_State {
   SASS_COMPILER_CREATED,
@@ -55,6 +59,23 @@ ADDAPI void ADDCALL sass_delete_compiler(struct Sass_Compiler* compiler);
 ADDAPI void ADDCALL sass_delete_file_context (struct Sass_File_Context* ctx);
 ADDAPI void ADDCALL sass_delete_data_context (struct Sass_Data_Context* ctx);
 
+// Create a long lived pool that keeps the setup (cwd, include paths, plugins,
+// custom functions, importers and headers) of the given options. The values
+// of the options are passed away (like with sass_*_context_set_options).
+ADDAPI struct Sass_Compiler_Pool* ADDCALL sass_make_compiler_pool (struct Sass_Options* options);
+// Compile a context with the setup of the pool, options of the context are
+// used for this compilation only (paths and custom functions are appended)
+// The pool can be shared by multiple threads at once, imported files are
+// only parsed once for all compilations (until they are modified on disk)
+// Names of variables, functions, mixins and custom units are interned in
+// one table per process, which is never released. It grows with every new
+// name, so hosts compiling ever changing sheets (watchers) keep all names
+// they have seen until the process ends (a few bytes per distinct name).
+ADDAPI int ADDCALL sass_compiler_pool_compile_file (struct Sass_Compiler_Pool* pool, struct Sass_File_Context* ctx);
+ADDAPI int ADDCALL sass_compiler_pool_compile_data (struct Sass_Compiler_Pool* pool, struct Sass_Data_Context* ctx);
+// Release the pool (contexts compiled with it are not affected)
+ADDAPI void ADDCALL sass_delete_compiler_pool (struct Sass_Compiler_Pool* pool);
+
 // Getters for context from specific implementation
 ADDAPI struct Sass_Context* ADDCALL sass_file_context_get_context (struct Sass_File_Context* file_ctx);
 ADDAPI struct Sass_Context* ADDCALL sass_data_context_get_context (struct Sass_Data_Context* data_ctx);
@@ -86,6 +107,8 @@ ADDAPI const char* ADDCALL sass_option_get_source_map_root (struct Sass_Options*
 ADDAPI Sass_Importer_List ADDCALL sass_option_get_c_headers (struct Sass_Options* options);
 ADDAPI Sass_Importer_List ADDCALL sass_option_get_c_importers (struct Sass_Options* options);
 ADDAPI Sass_Function_List ADDCALL sass_option_get_c_functions (struct Sass_Options* options);
+ADDAPI Sass_Output_Writer ADDCALL sass_option_get_output_writer (struct Sass_Options* options);
+ADDAPI void* ADDCALL sass_option_get_output_writer_cookie (struct Sass_Options* options);
 
 // Setters for Context_Option values
 ADDAPI void ADDCALL sass_option_set_precision (struct Sass_Options* options, int precision);
@@ -106,6 +129,15 @@ ADDAPI void ADDCALL sass_option_set_source_map_root (struct Sass_Options* option
 ADDAPI void ADDCALL sass_option_set_c_headers (struct Sass_Options* options, Sass_Importer_List c_headers);
 ADDAPI void ADDCALL sass_option_set_c_importers (struct Sass_Options* options, Sass_Importer_List c_importers);
 ADDAPI void ADDCALL sass_option_set_c_functions (struct Sass_Options* options, Sass_Function_List c_functions);
+// Stream the css output to the writer instead of the output string (which
+// stays empty). The output is the same as without a writer. The first
+// chunk (64KB) is held back until all imports were emitted (they are put
+// on top). If the sources have non-ascii characters, escapes or there are
+// custom functions, it also waits for the first non-ascii character (that
+// adds a charset on top), so such sheets may be written all at the end.
+// On errors the writer may already have received parts of the output.
+ADDAPI void ADDCALL sass_option_set_output_writer (struct Sass_Options* options, Sass_Output_Writer output_writer);
+ADDAPI void ADDCALL sass_option_set_output_writer_cookie (struct Sass_Options* options, void* output_writer_cookie);
 
 
 // Getters for Sass_Context values
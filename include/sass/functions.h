@@ -60,6 +60,8 @@ ADDAPI Sass_Import_Entry ADDCALL sass_make_import_entry (const char* path, char*
 ADDAPI Sass_Import_Entry ADDCALL sass_make_import (const char* imp_path, const char* abs_base, char* source, char* srcmap);
 // set error message to abort import and to print out a message (path from existing object is used in output)
 ADDAPI Sass_Import_Entry ADDCALL sass_import_set_error(Sass_Import_Entry import, const char* message, size_t line, size_t col);
+// promise that the same key always returns the same source (parsed style sheet is reused by compiler pools)
+ADDAPI Sass_Import_Entry ADDCALL sass_import_set_cache_key(Sass_Import_Entry import, const char* key);
 
 // Setters to insert an entry into the import list (you may also use [] access directly)
 // Since we are dealing with pointers they should have a guaranteed and fixed size
@@ -71,6 +73,7 @@ ADDAPI const char* ADDCALL sass_import_get_imp_path (Sass_Import_Entry);
 ADDAPI const char* ADDCALL sass_import_get_abs_path (Sass_Import_Entry);
 ADDAPI const char* ADDCALL sass_import_get_source (Sass_Import_Entry);
 ADDAPI const char* ADDCALL sass_import_get_srcmap (Sass_Import_Entry);
+ADDAPI const char* ADDCALL sass_import_get_cache_key (Sass_Import_Entry);
 // Explicit functions to take ownership of these items
 // The property on our struct will be reset to NULL
 ADDAPI char* ADDCALL sass_import_take_source (Sass_Import_Entry);
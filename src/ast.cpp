@@ -1632,8 +1632,8 @@ namespace Sass {
   : Value(pstate),
     value_(val),
     zero_(zero),
-    numerator_units_(std::vector<std::string>()),
-    denominator_units_(std::vector<std::string>()),
+    numerator_units_(),
+    denominator_units_(),
     hash_(0)
   {
     size_t l = 0, r = 0;
@@ -1643,8 +1643,8 @@ namespace Sass {
         r = u.find_first_of("*/", l);
         std::string unit(u.substr(l, r == std::string::npos ? r : r - l));
         if (!unit.empty()) {
-          if (nominator) numerator_units_.push_back(unit);
-          else denominator_units_.push_back(unit);
+          if (nominator) numerator_units_.push_back(intern_unit(unit));
+          else denominator_units_.push_back(intern_unit(unit));
         }
         if (r == std::string::npos) break;
         // ToDo: should error for multiple slashes
@@ -1662,12 +1662,12 @@ namespace Sass {
     std::string u;
     for (size_t i = 0, S = numerator_units_.size(); i < S; ++i) {
       if (i) u += '*';
-      u += numerator_units_[i];
+      u += unit_name(numerator_units_[i]);
     }
     if (!denominator_units_.empty()) u += '/';
     for (size_t i = 0, S = denominator_units_.size(); i < S; ++i) {
       if (i) u += '*';
-      u += denominator_units_[i];
+      u += unit_name(denominator_units_[i]);
     }
     return u;
   }
@@ -1681,51 +1681,54 @@ namespace Sass {
   bool Number::is_unitless() const
   { return numerator_units_.empty() && denominator_units_.empty(); }
 
-  void Number::normalize(const std::string& prefered, bool strict)
+  bool Number::has_same_units(const Number& rhs) const
   {
+    return numerator_units_ == rhs.numerator_units_ &&
+           denominator_units_ == rhs.denominator_units_;
+  }
+
+  void Number::normalize(Unit prefered, bool strict)
+  {
+
+    // a single unit stays as it is
+    if (prefered == UNKNOWN && numerator_units_.size() + denominator_units_.size() < 2) return;
 
     // first make sure same units cancel each other out
-    // it seems that a map table will fit nicely to do this
     // we basically construct exponents for each unit
-    // has the advantage that they will be pre-sorted
-    std::map<std::string, int> exponents;
-
-    // initialize by summing up occurences in unit vectors
-    for (size_t i = 0, S = numerator_units_.size(); i < S; ++i) ++ exponents[numerator_units_[i]];
-    for (size_t i = 0, S = denominator_units_.size(); i < S; ++i) -- exponents[denominator_units_[i]];
+    Unit_Exponents exponents(numerator_units_, denominator_units_);
 
     // the final conversion factor
     double factor = 1;
 
     // get the first entry of numerators
     // forward it when entry is converted
-    std::vector<std::string>::iterator nom_it = numerator_units_.begin();
-    std::vector<std::string>::iterator nom_end = numerator_units_.end();
-    std::vector<std::string>::iterator denom_it = denominator_units_.begin();
-    std::vector<std::string>::iterator denom_end = denominator_units_.end();
+    size_t nom_it = 0, nom_end = numerator_units_.size();
+    size_t denom_it = 0, denom_end = denominator_units_.size();
 
     // main normalization loop
     // should be close to optimal
     while (denom_it != denom_end)
     {
       // get and increment afterwards
-      const std::string denom = *(denom_it ++);
+      const Unit denom = denominator_units_[denom_it ++];
       // skip already canceled out unit
       if (exponents[denom] >= 0) continue;
       // skip all units we don't know how to convert
-      if (string_to_unit(denom) == UNKNOWN) continue;
+      if (unit_type(denom) == UNKNOWN) continue;
       // now search for nominator
       while (nom_it != nom_end)
       {
         // get and increment afterwards
-        const std::string nom = *(nom_it ++);
+        const Unit nom = numerator_units_[nom_it ++];
         // skip already canceled out unit
         if (exponents[nom] <= 0) continue;
         // skip all units we don't know how to convert
-        if (string_to_unit(nom) == UNKNOWN) continue;
-        // we now have two convertable units
+        if (unit_type(nom) == UNKNOWN) continue;
+        // units of another class simply don't cancel
+        double conversion = conversion_factor(nom, denom, false);
+        if (conversion == 0) continue;
         // add factor for current conversion
-        factor *= conversion_factor(nom, denom, strict);
+        factor *= conversion;
         // update nominator/denominator exponent
         -- exponents[nom]; ++ exponents[denom];
         // inner loop done
@@ -1734,24 +1737,7 @@ namespace Sass {
     }
 
     // now we can build up the new unit arrays
-    numerator_units_.clear();
-    denominator_units_.clear();
-
-    // build them by iterating over the exponents
-    for (auto exp : exponents)
-    {
-      // maybe there is more effecient way to push
-      // the same item multiple times to a vector?
-      for(size_t i = 0, S = abs(exp.second); i < S; ++i)
-      {
-        // opted to have these switches in the inner loop
-        // makes it more readable and should not cost much
-        if (!exp.first.empty()) {
-          if (exp.second < 0) denominator_units_.push_back(exp.first);
-          else if (exp.second > 0) numerator_units_.push_back(exp.first);
-        }
-      }
-    }
+    exponents.build(numerator_units_, denominator_units_);
 
     // apply factor to value_
     // best precision this way
@@ -1770,22 +1756,11 @@ namespace Sass {
   double Number::convert_factor(const Number& n) const
   {
 
-    // first make sure same units cancel each other out
-    // it seems that a map table will fit nicely to do this
-    // we basically construct exponents for each unit class
-    // std::map<std::string, int> exponents;
-    // initialize by summing up occurences in unit vectors
-    // for (size_t i = 0, S = numerator_units_.size(); i < S; ++i) ++ exponents[unit_to_class(numerator_units_[i])];
-    // for (size_t i = 0, S = denominator_units_.size(); i < S; ++i) -- exponents[unit_to_class(denominator_units_[i])];
-
-    std::vector<std::string> l_miss_nums(0);
-    std::vector<std::string> l_miss_dens(0);
+    Unit_List l_miss_nums;
+    Unit_List l_miss_dens;
     // create copy since we need these for state keeping
-    std::vector<std::string> r_nums(n.numerator_units_);
-    std::vector<std::string> r_dens(n.denominator_units_);
-
-    std::vector<std::string>::const_iterator l_num_it = numerator_units_.begin();
-    std::vector<std::string>::const_iterator l_num_end = numerator_units_.end();
+    Unit_List r_nums(n.numerator_units_);
+    Unit_List r_dens(n.denominator_units_);
 
     bool l_unitless = is_unitless();
     bool r_unitless = n.is_unitless();
@@ -1794,31 +1769,22 @@ namespace Sass {
     double factor = 1;
 
     // process all left numerators
-    while (l_num_it != l_num_end)
+    for (size_t i = 0, S = numerator_units_.size(); i < S; ++i)
     {
-      // get and increment afterwards
-      const std::string l_num = *(l_num_it ++);
-
-      std::vector<std::string>::iterator r_num_it = r_nums.begin();
-      std::vector<std::string>::iterator r_num_end = r_nums.end();
+      const Unit l_num = numerator_units_[i];
 
       bool found = false;
       // search for compatible numerator
-      while (r_num_it != r_num_end)
+      for (size_t j = 0; j < r_nums.size(); ++j)
       {
-        // get and increment afterwards
-        const std::string r_num = *(r_num_it);
         // get possible converstion factor for units
-        double conversion = conversion_factor(l_num, r_num, false);
+        double conversion = conversion_factor(l_num, r_nums[j], false);
         // skip incompatible numerator
-        if (conversion == 0) {
-          ++ r_num_it;
-          continue;
-        }
+        if (conversion == 0) continue;
         // apply to global factor
         factor *= conversion;
         // remove item from vector
-        r_nums.erase(r_num_it);
+        r_nums.erase(j);
         // found numerator
         found = true;
         break;
@@ -1828,35 +1794,23 @@ namespace Sass {
       if (!found) l_miss_nums.push_back(l_num);
     }
 
-    std::vector<std::string>::const_iterator l_den_it = denominator_units_.begin();
-    std::vector<std::string>::const_iterator l_den_end = denominator_units_.end();
-
     // process all left denominators
-    while (l_den_it != l_den_end)
+    for (size_t i = 0, S = denominator_units_.size(); i < S; ++i)
     {
-      // get and increment afterwards
-      const std::string l_den = *(l_den_it ++);
-
-      std::vector<std::string>::iterator r_den_it = r_dens.begin();
-      std::vector<std::string>::iterator r_den_end = r_dens.end();
+      const Unit l_den = denominator_units_[i];
 
       bool found = false;
       // search for compatible denominator
-      while (r_den_it != r_den_end)
+      for (size_t j = 0; j < r_dens.size(); ++j)
       {
-        // get and increment afterwards
-        const std::string r_den = *(r_den_it);
         // get possible converstion factor for units
-        double conversion = conversion_factor(l_den, r_den, false);
+        double conversion = conversion_factor(l_den, r_dens[j], false);
         // skip incompatible denominator
-        if (conversion == 0) {
-          ++ r_den_it;
-          continue;
-        }
+        if (conversion == 0) continue;
         // apply to global factor
         factor *= conversion;
         // remove item from vector
-        r_dens.erase(r_den_it);
+        r_dens.erase(j);
         // found denominator
         found = true;
         break;
@@ -1884,86 +1838,61 @@ namespace Sass {
   }
 
   // this does not cover all cases (multiple prefered units)
-  bool Number::convert(const std::string& prefered, bool strict)
+  bool Number::convert(Unit prefered, bool strict)
   {
     // no conversion if unit is empty
-    if (prefered.empty()) return true;
+    if (prefered == UNKNOWN) return true;
 
     // first make sure same units cancel each other out
-    // it seems that a map table will fit nicely to do this
     // we basically construct exponents for each unit
-    // has the advantage that they will be pre-sorted
-    std::map<std::string, int> exponents;
-
-    // initialize by summing up occurences in unit vectors
-    for (size_t i = 0, S = numerator_units_.size(); i < S; ++i) ++ exponents[numerator_units_[i]];
-    for (size_t i = 0, S = denominator_units_.size(); i < S; ++i) -- exponents[denominator_units_[i]];
+    Unit_Exponents exponents(numerator_units_, denominator_units_);
 
     // the final conversion factor
     double factor = 1;
 
-    std::vector<std::string>::iterator denom_it = denominator_units_.begin();
-    std::vector<std::string>::iterator denom_end = denominator_units_.end();
-
     // main normalization loop
     // should be close to optimal
-    while (denom_it != denom_end)
+    for (size_t i = 0, S = denominator_units_.size(); i < S; ++i)
     {
-      // get and increment afterwards
-      const std::string denom = *(denom_it ++);
+      const Unit denom = denominator_units_[i];
       // check if conversion is needed
       if (denom == prefered) continue;
       // skip already canceled out unit
       if (exponents[denom] >= 0) continue;
       // skip all units we don't know how to convert
-      if (string_to_unit(denom) == UNKNOWN) continue;
-      // we now have two convertable units
+      if (unit_type(denom) == UNKNOWN) continue;
+      // we now have two units, maybe convertable
+      double conversion = conversion_factor(denom, prefered, strict);
+      // skip units of another class
+      if (conversion == 0) continue;
       // add factor for current conversion
-      factor *= conversion_factor(denom, prefered, strict);
+      factor *= conversion;
       // update nominator/denominator exponent
       ++ exponents[denom]; -- exponents[prefered];
     }
 
-    std::vector<std::string>::iterator nom_it = numerator_units_.begin();
-    std::vector<std::string>::iterator nom_end = numerator_units_.end();
-
     // now search for nominator
-    while (nom_it != nom_end)
+    for (size_t i = 0, S = numerator_units_.size(); i < S; ++i)
     {
-      // get and increment afterwards
-      const std::string nom = *(nom_it ++);
+      const Unit nom = numerator_units_[i];
       // check if conversion is needed
       if (nom == prefered) continue;
       // skip already canceled out unit
       if (exponents[nom] <= 0) continue;
       // skip all units we don't know how to convert
-      if (string_to_unit(nom) == UNKNOWN) continue;
-      // we now have two convertable units
+      if (unit_type(nom) == UNKNOWN) continue;
+      // we now have two units, maybe convertable
+      double conversion = conversion_factor(nom, prefered, strict);
+      // skip units of another class
+      if (conversion == 0) continue;
       // add factor for current conversion
-      factor *= conversion_factor(nom, prefered, strict);
+      factor *= conversion;
       // update nominator/denominator exponent
       -- exponents[nom]; ++ exponents[prefered];
     }
 
     // now we can build up the new unit arrays
-    numerator_units_.clear();
-    denominator_units_.clear();
-
-    // build them by iterating over the exponents
-    for (auto exp : exponents)
-    {
-      // maybe there is more effecient way to push
-      // the same item multiple times to a vector?
-      for(size_t i = 0, S = abs(exp.second); i < S; ++i)
-      {
-        // opted to have these switches in the inner loop
-        // makes it more readable and should not cost much
-        if (!exp.first.empty()) {
-          if (exp.second < 0) denominator_units_.push_back(exp.first);
-          else if (exp.second > 0) numerator_units_.push_back(exp.first);
-        }
-      }
-    }
+    exponents.build(numerator_units_, denominator_units_);
 
     // apply factor to value_
     // best precision this way
@@ -1975,17 +1904,15 @@ namespace Sass {
   }
 
   // useful for making one number compatible with another
-  std::string Number::find_convertible_unit() const
+  Unit Number::find_convertible_unit() const
   {
     for (size_t i = 0, S = numerator_units_.size(); i < S; ++i) {
-      std::string u(numerator_units_[i]);
-      if (string_to_unit(u) != UNKNOWN) return u;
+      if (unit_type(numerator_units_[i]) != UNKNOWN) return numerator_units_[i];
     }
     for (size_t i = 0, S = denominator_units_.size(); i < S; ++i) {
-      std::string u(denominator_units_[i]);
-      if (string_to_unit(u) != UNKNOWN) return u;
+      if (unit_type(denominator_units_[i]) != UNKNOWN) return denominator_units_[i];
     }
-    return std::string();
+    return UNKNOWN;
   }
 
   bool Custom_Warning::operator== (const Expression& rhs) const
@@ -2013,8 +1940,7 @@ namespace Sass {
       if (!lhs_units || !rhs_units) {
         return std::fabs(value() - r->value()) < NUMBER_EPSILON;
       }
-      return (numerator_units_ == r->numerator_units_) &&
-             (denominator_units_ == r->denominator_units_) &&
+      return has_same_units(*r) &&
              std::fabs(value() - r->value()) < NUMBER_EPSILON;
     }
     return false;
@@ -2031,9 +1957,7 @@ namespace Sass {
 
     Number tmp_r(rhs);
     tmp_r.normalize(find_convertible_unit());
-    std::string l_unit(unit());
-    std::string r_unit(tmp_r.unit());
-    if (unit() != tmp_r.unit()) {
+    if (!has_same_units(tmp_r)) {
       error("cannot compare numbers with incompatible units", pstate());
     }
     return value() < tmp_r.value();
@@ -2154,13 +2078,83 @@ namespace Sass {
     return length();
   }
 
+  size_t Hashed::index_of(Expression* k) const
+  {
+    ExpressionIndex::const_iterator it = entries_->index.find(k);
+    // entries after our length belong to other maps
+    if (it == entries_->index.end() || it->second >= length_) return length_;
+    return it->second;
+  }
+
+  void Hashed::detach(bool appending)
+  {
+    // appending is fine if we see all entries
+    if (appending && length_ == entries_->keys.size()) return;
+    // altering a value needs our own entries
+    if (!appending && entries_.use_count() == 1) return;
+    // copy the entries we can see
+    std::shared_ptr<Entries> entries(std::make_shared<Entries>());
+    entries->keys.assign(entries_->keys.begin(), entries_->keys.begin() + length_);
+    entries->values.assign(entries_->values.begin(), entries_->values.begin() + length_);
+    entries->index.reserve(length_);
+    for (size_t i = 0; i < length_; ++i) entries->index[entries->keys[i]] = i;
+    entries_ = entries;
+  }
+
+  Expression* Hashed::find(Expression* k) const
+  {
+    size_t i = index_of(k);
+    return i != length_ ? entries_->values[i] : 0;
+  }
+
   Expression* Hashed::at(Expression* k) const
   {
-    if (elements_.count(k))
-    { return elements_.at(k); }
+    if (Expression* v = find(k))
+    { return v; }
     else { return &sass_null; }
   }
 
+  Hashed& Hashed::operator<<(std::pair<Expression*, Expression*> p)
+  {
+    reset_hash();
+
+    size_t i = index_of(p.first);
+    if (i == length_) {
+      detach(true);
+      entries_->keys.push_back(p.first);
+      entries_->values.push_back(p.second);
+      entries_->index[p.first] = length_;
+      ++ length_;
+    }
+    else {
+      if (!duplicate_key_) duplicate_key_ = p.first;
+      detach(false);
+      entries_->values[i] = p.second;
+    }
+
+    adjust_after_pushing(p);
+    return *this;
+  }
+
+  Hashed& Hashed::operator+=(Hashed* h)
+  {
+    if (length() == 0) {
+      // share the entries
+      this->entries_ = h->entries_;
+      this->length_ = h->length_;
+      return *this;
+    }
+
+    // keep them alive, we may share them
+    std::shared_ptr<Entries> entries(h->entries_);
+    for (size_t i = 0, L = h->length_; i < L; ++i) {
+      *this << std::make_pair(entries->keys[i], entries->values[i]);
+    }
+
+    reset_duplicate_key();
+    return *this;
+  }
+
   bool Binary_Expression::is_left_interpolant(void) const
   {
     return is_interpolant() || (left() && left()->is_left_interpolant());
@@ -8,6 +8,7 @@
 #include <sstream>
 #include <iostream>
 #include <typeinfo>
+#include <memory>
 #include <algorithm>
 #include <unordered_map>
 #include "sass/base.h"
@@ -280,6 +281,11 @@ namespace Sass {
   /////////////////////////////////////////////////////////////////////////////
   // Mixin class for AST nodes that should behave like a hash table. Uses an
   // extra <std::vector> internally to maintain insertion order for interation.
+  // Entries are stored append-only and are shared between copies, every map
+  // only sees the first `length` entries. A map that sees all entries may
+  // append in place, since no other map can see the new ones. Otherwise it
+  // copies its entries first. This makes copies and merges with new keys
+  // (i.e. `$map: map-merge($map, (key: value))`) independent of the size.
   /////////////////////////////////////////////////////////////////////////////
   class Hashed {
   struct HashExpression {
@@ -294,13 +300,37 @@ namespace Sass {
   };
   typedef std::unordered_map<
     Expression*, // key
-    Expression*, // value
+    size_t, // position
     HashExpression, // hasher
     CompareExpression // compare
-  > ExpressionMap;
+  > ExpressionIndex;
+  // shared by all copies of a map
+  struct Entries {
+    std::vector<Expression*> keys;
+    std::vector<Expression*> values;
+    ExpressionIndex index;
+  };
+  public:
+    // keys visible to a map (in insertion order)
+    class Keys {
+      const std::vector<Expression*>* keys_;
+      size_t length_;
+    public:
+      typedef std::vector<Expression*>::const_iterator const_iterator;
+      Keys(const std::vector<Expression*>* keys, size_t length)
+      : keys_(keys), length_(length) { }
+      size_t size() const { return length_; }
+      Expression* operator[](size_t i) const { return (*keys_)[i]; }
+      const_iterator begin() const { return keys_->begin(); }
+      const_iterator end() const { return keys_->begin() + length_; }
+    };
   private:
-    ExpressionMap elements_;
-    std::vector<Expression*> list_;
+    std::shared_ptr<Entries> entries_;
+    size_t length_;
+    // position of key or length if not found
+    size_t index_of(Expression* k) const;
+    // make sure we can alter the entries
+    void detach(bool appending);
   protected:
     size_t hash_;
     Expression* duplicate_key_;
@@ -308,50 +338,25 @@ namespace Sass {
     void reset_duplicate_key() { duplicate_key_ = 0; }
     virtual void adjust_after_pushing(std::pair<Expression*, Expression*> p) { }
   public:
-    Hashed(size_t s = 0) : elements_(ExpressionMap(s)), list_(std::vector<Expression*>())
-    { elements_.reserve(s); list_.reserve(s); reset_duplicate_key(); }
+    Hashed(size_t s = 0) : entries_(std::make_shared<Entries>()), length_(0)
+    {
+      entries_->keys.reserve(s);
+      entries_->values.reserve(s);
+      entries_->index.reserve(s);
+      reset_duplicate_key();
+    }
     virtual ~Hashed();
-    size_t length() const                  { return list_.size(); }
-    bool empty() const                     { return list_.empty(); }
-    bool has(Expression* k) const          { return elements_.count(k) == 1; }
+    size_t length() const                  { return length_; }
+    bool empty() const                     { return length_ == 0; }
+    bool has(Expression* k) const          { return index_of(k) != length_; }
+    // value of key or null if not found
+    Expression* find(Expression* k) const;
     Expression* at(Expression* k) const;
     bool has_duplicate_key() const         { return duplicate_key_ != 0; }
     Expression* get_duplicate_key() const  { return duplicate_key_; }
-    const ExpressionMap elements() { return elements_; }
-    Hashed& operator<<(std::pair<Expression*, Expression*> p)
-    {
-      reset_hash();
-
-      if (!has(p.first)) list_.push_back(p.first);
-      else if (!duplicate_key_) duplicate_key_ = p.first;
-
-      elements_[p.first] = p.second;
-
-      adjust_after_pushing(p);
-      return *this;
-    }
-    Hashed& operator+=(Hashed* h)
-    {
-      if (length() == 0) {
-        this->elements_ = h->elements_;
-        this->list_ = h->list_;
-        return *this;
-      }
-
-      for (auto key : h->keys()) {
-        *this << std::make_pair(key, h->at(key));
-      }
-
-      reset_duplicate_key();
-      return *this;
-    }
-    const ExpressionMap& pairs() const { return elements_; }
-    const std::vector<Expression*>& keys() const { return list_; }
-
-    std::unordered_map<Expression*, Expression*>::iterator end() { return elements_.end(); }
-    std::unordered_map<Expression*, Expression*>::iterator begin() { return elements_.begin(); }
-    std::unordered_map<Expression*, Expression*>::const_iterator end() const { return elements_.end(); }
-    std::unordered_map<Expression*, Expression*>::const_iterator begin() const { return elements_.begin(); }
+    Hashed& operator<<(std::pair<Expression*, Expression*> p);
+    Hashed& operator+=(Hashed* h);
+    Keys keys() const { return Keys(&entries_->keys, length_); }
 
   };
   inline Hashed::~Hashed() { }
@@ -586,6 +591,10 @@ namespace Sass {
   /////////////////////////////////////
   class Assignment : public Statement {
     ADD_PROPERTY(std::string, variable)
+    ADD_PROPERTY(Symbol, symbol)
+    // distance to the frame holding the variable
+    // set by the resolver (-1 for dynamic lookup)
+    ADD_PROPERTY(int, depth)
     ADD_PROPERTY(Expression*, value)
     ADD_PROPERTY(bool, is_default)
     ADD_PROPERTY(bool, is_global)
@@ -594,7 +603,8 @@ namespace Sass {
                std::string var, Expression* val,
                bool is_default = false,
                bool is_global = false)
-    : Statement(pstate), variable_(var), value_(val), is_default_(is_default), is_global_(is_global)
+    : Statement(pstate), variable_(var), symbol_(Symbol_Table::intern(var)), depth_(-1),
+      value_(val), is_default_(is_default), is_global_(is_global)
     { statement_type(ASSIGNMENT); }
     ATTACH_OPERATIONS()
   };
@@ -849,10 +859,12 @@ namespace Sass {
   //////////////////////////////////////
   class Mixin_Call : public Has_Block {
     ADD_PROPERTY(std::string, name)
+    // interned name of the mixin definition
+    ADD_PROPERTY(Symbol, symbol)
     ADD_PROPERTY(Arguments*, arguments)
   public:
     Mixin_Call(ParserState pstate, std::string n, Arguments* args, Block* b = 0)
-    : Has_Block(pstate, b), name_(n), arguments_(args)
+    : Has_Block(pstate, b), name_(n), symbol_(Symbol_Table::intern(n + "[m]")), arguments_(args)
     { }
     ATTACH_OPERATIONS()
   };
@@ -1197,15 +1209,38 @@ namespace Sass {
   //////////////////
   class Function_Call : public PreValue {
     ADD_HASHED(std::string, name)
+    // interned name of the function definition
+    ADD_PROPERTY(Symbol, symbol)
     ADD_HASHED(Arguments*, arguments)
     ADD_PROPERTY(void*, cookie)
+    // inline cache for the definition lookup
+    // valid while called from the same scope
+    // and no other definitions got registered
+    ADD_PROPERTY(Env*, cached_scope)
+    ADD_PROPERTY(size_t, cached_stamp)
+    ADD_PROPERTY(Symbol, cached_symbol)
+    ADD_PROPERTY(Definition*, cached_definition)
     size_t hash_;
   public:
     Function_Call(ParserState pstate, std::string n, Arguments* args, void* cookie)
-    : PreValue(pstate), name_(n), arguments_(args), cookie_(cookie), hash_(0)
+    : PreValue(pstate), name_(n), symbol_(Symbol_Table::intern(Util::normalize_underscores(n) + "[f]")),
+      arguments_(args), cookie_(cookie),
+      cached_scope_(0), cached_stamp_(0), cached_symbol_(0), cached_definition_(0),
+      hash_(0)
     { concrete_type(STRING); }
     Function_Call(ParserState pstate, std::string n, Arguments* args)
-    : PreValue(pstate), name_(n), arguments_(args), cookie_(0), hash_(0)
+    : PreValue(pstate), name_(n), symbol_(Symbol_Table::intern(Util::normalize_underscores(n) + "[f]")),
+      arguments_(args), cookie_(0),
+      cached_scope_(0), cached_stamp_(0), cached_symbol_(0), cached_definition_(0),
+      hash_(0)
+    { concrete_type(STRING); }
+    // for calls built at runtime, the symbol is only looked up
+    // (zero if no definition could ever have been registered)
+    Function_Call(ParserState pstate, std::string n, Symbol sym, Arguments* args)
+    : PreValue(pstate), name_(n), symbol_(sym),
+      arguments_(args), cookie_(0),
+      cached_scope_(0), cached_stamp_(0), cached_symbol_(0), cached_definition_(0),
+      hash_(0)
     { concrete_type(STRING); }
 
     virtual bool operator==(const Expression& rhs) const
@@ -1257,9 +1292,13 @@ namespace Sass {
   ///////////////////////
   class Variable : public PreValue {
     ADD_PROPERTY(std::string, name)
+    ADD_PROPERTY(Symbol, symbol)
+    // distance to the frame holding the variable
+    // set by the resolver (-1 for dynamic lookup)
+    ADD_PROPERTY(int, depth)
   public:
     Variable(ParserState pstate, std::string n)
-    : PreValue(pstate), name_(n)
+    : PreValue(pstate), name_(n), symbol_(Symbol_Table::intern(n)), depth_(-1)
     { }
 
     virtual bool operator==(const Expression& rhs) const
@@ -1333,36 +1372,39 @@ namespace Sass {
   class Number : public Value {
     ADD_HASHED(double, value)
     ADD_PROPERTY(bool, zero)
-    std::vector<std::string> numerator_units_;
-    std::vector<std::string> denominator_units_;
+    Unit_List numerator_units_;
+    Unit_List denominator_units_;
     size_t hash_;
   public:
     Number(ParserState pstate, double val, std::string u = "", bool zero = true);
     bool zero() { return zero_; }
     bool is_valid_css_unit() const;
-    std::vector<std::string>& numerator_units()   { return numerator_units_; }
-    std::vector<std::string>& denominator_units() { return denominator_units_; }
-    const std::vector<std::string>& numerator_units() const   { return numerator_units_; }
-    const std::vector<std::string>& denominator_units() const { return denominator_units_; }
+    Unit_List& numerator_units()   { return numerator_units_; }
+    Unit_List& denominator_units() { return denominator_units_; }
+    const Unit_List& numerator_units() const   { return numerator_units_; }
+    const Unit_List& denominator_units() const { return denominator_units_; }
     std::string type() { return "number"; }
     static std::string type_name() { return "number"; }
     std::string unit() const;
 
     bool is_unitless() const;
+    // same units (in the same order)
+    bool has_same_units(const Number& rhs) const;
     double convert_factor(const Number&) const;
-    bool convert(const std::string& unit = "", bool strict = false);
-    void normalize(const std::string& unit = "", bool strict = false);
+    bool convert(Unit unit = UNKNOWN, bool strict = false);
+    void normalize(Unit unit = UNKNOWN, bool strict = false);
     // useful for making one number compatible with another
-    std::string find_convertible_unit() const;
+    // returns UNKNOWN if there is no convertible unit
+    Unit find_convertible_unit() const;
 
     virtual size_t hash()
     {
       if (hash_ == 0) {
         hash_ = std::hash<double>()(value_);
         for (const auto numerator : numerator_units())
-          hash_combine(hash_, std::hash<std::string>()(numerator));
+          hash_combine(hash_, std::hash<Unit>()(numerator));
         for (const auto denominator : denominator_units())
-          hash_combine(hash_, std::hash<std::string>()(denominator));
+          hash_combine(hash_, std::hash<Unit>()(denominator));
       }
       return hash_;
     }
@@ -1804,12 +1846,14 @@ namespace Sass {
   /////////////////////////////////////////////////////////
   class Parameter : public AST_Node {
     ADD_PROPERTY(std::string, name)
+    ADD_PROPERTY(Symbol, symbol)
     ADD_PROPERTY(Expression*, default_value)
     ADD_PROPERTY(bool, is_rest_parameter)
   public:
     Parameter(ParserState pstate,
               std::string n, Expression* def = 0, bool rest = false)
-    : AST_Node(pstate), name_(n), default_value_(def), is_rest_parameter_(rest)
+    : AST_Node(pstate), name_(n), symbol_(Symbol_Table::intern(n)),
+      default_value_(def), is_rest_parameter_(rest)
     {
       if (default_value_ && is_rest_parameter_) {
         error("variable-length parameter may not have a default value", pstate);
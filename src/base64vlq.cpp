@@ -5,9 +5,19 @@ namespace Sass {
 
   std::string Base64VLQ::encode(const int number) const
   {
-    std::string encoded = "";
+    char buffer[MAX_LENGTH];
+    return std::string(buffer, encode(number, buffer));
+  }
+
+  char* Base64VLQ::encode(const int number, char* buffer) const
+  {
+    uint64_t vlq = to_vlq_signed(number);
 
-    int vlq = to_vlq_signed(number);
+    // most deltas fit into one digit
+    if (vlq < (uint64_t) VLQ_BASE) {
+      *buffer++ = CHARACTERS[vlq];
+      return buffer;
+    }
 
     do {
       int digit = vlq & VLQ_BASE_MASK;
@@ -15,27 +25,31 @@ namespace Sass {
       if (vlq > 0) {
         digit |= VLQ_CONTINUATION_BIT;
       }
-      encoded += base64_encode(digit);
+      *buffer++ = CHARACTERS[digit];
     } while (vlq > 0);
 
-    return encoded;
+    return buffer;
   }
 
-  char Base64VLQ::base64_encode(const int number) const
+  char* Base64VLQ::encode(const int* numbers, size_t count, char* buffer) const
   {
-    int index = number;
-    if (index < 0) index = 0;
-    if (index > 63) index = 63;
-    return CHARACTERS[index];
+    for (size_t i = 0; i < count; ++i) {
+      buffer = encode(numbers[i], buffer);
+    }
+    return buffer;
   }
 
-  int Base64VLQ::to_vlq_signed(const int number) const
+  uint64_t Base64VLQ::to_vlq_signed(const int number) const
   {
-    return (number < 0) ? ((-number) << 1) + 1 : (number << 1) + 0;
+    // widen first, so INT_MIN does not overflow
+    int64_t value = number;
+    return (value < 0) ? ((uint64_t)(-value) << 1) + 1 : ((uint64_t) value << 1) + 0;
   }
 
   const char* Base64VLQ::CHARACTERS = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
+  const size_t Base64VLQ::MAX_LENGTH;
+
   const int Base64VLQ::VLQ_BASE_SHIFT = 5;
   const int Base64VLQ::VLQ_BASE = 1 << VLQ_BASE_SHIFT;
   const int Base64VLQ::VLQ_BASE_MASK = VLQ_BASE - 1;
@@ -2,6 +2,7 @@
 #define SASS_BASE64VLQ_H
 
 #include <string>
+#include <stdint.h>
 
 namespace Sass {
 
@@ -9,13 +10,19 @@ namespace Sass {
 
   public:
 
+    // most characters needed for one number
+    static const size_t MAX_LENGTH = 7;
+
     std::string encode(const int number) const;
 
-  private:
+    // write into a buffer with enough room (MAX_LENGTH
+    // per number) and return the end of the written data
+    char* encode(const int number, char* buffer) const;
+    char* encode(const int* numbers, size_t count, char* buffer) const;
 
-    char base64_encode(const int number) const;
+  private:
 
-    int to_vlq_signed(const int number) const;
+    uint64_t to_vlq_signed(const int number) const;
 
     static const char* CHARACTERS;
 
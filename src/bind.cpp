@@ -19,8 +19,11 @@ namespace Sass {
     for (size_t i = 0, L = as->length(); i < L; ++i) {
       if (auto str = dynamic_cast<String_Quoted*>((*as)[i]->value())) {
         // force optional quotes (only if needed)
-        if (str->quote_mark()) {
+        if (str->quote_mark() && str->quote_mark() != '*') {
+          // copy since the value may be shared
+          str = SASS_MEMORY_NEW(ctx->mem, String_Quoted, *str);
           str->quote_mark('*');
+          (*as)[i]->value(str);
         }
       }
     }
@@ -83,7 +86,7 @@ namespace Sass {
                 }
               }
               // assign new arglist to environment
-              env->local_frame()[p->name()] = arglist;
+              env->set_local(p->symbol(), arglist);
             }
           // invalid state
           else {
@@ -93,7 +96,7 @@ namespace Sass {
 
           // expand keyword arguments into their parameters
           List* arglist = SASS_MEMORY_NEW(ctx->mem, List, p->pstate(), 0, SASS_COMMA, true);
-          env->local_frame()[p->name()] = arglist;
+          env->set_local(p->symbol(), arglist);
           Map* argmap = static_cast<Map*>(a->value());
           for (auto key : argmap->keys()) {
             std::string name = unquote(static_cast<String_Constant*>(key)->value());
@@ -154,7 +157,7 @@ namespace Sass {
             }
           }
           // assign new arglist to environment
-          env->local_frame()[p->name()] = arglist;
+          env->set_local(p->symbol(), arglist);
         }
         // consumed parameter
         ++ip;
@@ -210,7 +213,7 @@ namespace Sass {
             msg << callee << " has no parameter named " << name;
             error(msg.str(), a->pstate());
           }
-          env->local_frame()[name] = argmap->at(key);
+          env->set_local(name, argmap->at(key));
         }
         ++ia;
         continue;
@@ -219,14 +222,14 @@ namespace Sass {
       }
 
       if (a->name().empty()) {
-        if (env->has_local(p->name())) {
+        if (env->has_local(p->symbol())) {
           std::stringstream msg;
           msg << "parameter " << p->name()
           << " provided more than once in call to " << callee;
           error(msg.str(), a->pstate());
         }
         // ordinal arg -- bind it to the next param
-        env->local_frame()[p->name()] = a->value();
+        env->set_local(p->symbol(), a->value());
         ++ip;
       }
       else {
@@ -248,7 +251,7 @@ namespace Sass {
               << "provided more than once in call to " << callee;
           error(msg.str(), a->pstate());
         }
-        env->local_frame()[a->name()] = a->value();
+        env->set_local(a->name(), a->value());
       }
     }
     // EO while ia
@@ -261,17 +264,17 @@ namespace Sass {
       // cerr << "env for default params:" << endl;
       // env->print();
       // cerr << "********" << endl;
-      if (!env->has_local(leftover->name())) {
+      if (!env->has_local(leftover->symbol())) {
         if (leftover->is_rest_parameter()) {
-          env->local_frame()[leftover->name()] = SASS_MEMORY_NEW(ctx->mem, List,
-                                                                   leftover->pstate(),
-                                                                   0,
-                                                                   SASS_COMMA,
-                                                                   true);
+          env->set_local(leftover->symbol(), SASS_MEMORY_NEW(ctx->mem, List,
+                                                             leftover->pstate(),
+                                                             0,
+                                                             SASS_COMMA,
+                                                             true));
         }
         else if (leftover->default_value()) {
           Expression* dv = leftover->default_value()->perform(eval);
-          env->local_frame()[leftover->name()] = dv;
+          env->set_local(leftover->symbol(), dv);
         }
         else {
           // param is unbound and has no default value -- error
@@ -0,0 +1,229 @@
+#include "sass.hpp"
+#include <stdint.h>
+#include <atomic>
+
+#include "char_scan.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #define SASS_SCAN_SSE2
+  #include <emmintrin.h>
+  #if defined(_MSC_VER)
+    #include <intrin.h>
+  #endif
+#endif
+
+// gcc and clang can compile single functions for avx2
+#if defined(SASS_SCAN_SSE2) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+  #define SASS_SCAN_AVX2
+  #include <immintrin.h>
+#endif
+
+namespace Sass {
+
+  // same as Prelexer::is_space
+  static inline bool is_space(char chr)
+  {
+    return chr == ' ' || unsigned(chr - '\t') <= '\r' - '\t';
+  }
+
+  static const char* scan_chars_scalar(const char* src, char a, char b, char c)
+  {
+    while (*src && *src != a && *src != b && *src != c) ++ src;
+    return src;
+  }
+
+  static const char* scan_spaces_scalar(const char* src)
+  {
+    while (is_space(*src)) ++ src;
+    return src;
+  }
+
+  // The vector versions only use aligned loads. These never cross
+  // into another page, so reading past the terminator is safe. The
+  // first block may start before src, its leading bits are dropped.
+  // Address and thread sanitizers still report these reads, so they
+  // are exempt from both.
+  #if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 8)
+    #define SASS_NO_SANITIZE_SCAN __attribute__((no_sanitize("address", "thread")))
+  #elif defined(__GNUC__) && __GNUC__ >= 5
+    #define SASS_NO_SANITIZE_SCAN __attribute__((no_sanitize_address, no_sanitize_thread))
+  #elif defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8))
+    #define SASS_NO_SANITIZE_SCAN __attribute__((no_sanitize_address))
+  #else
+    #define SASS_NO_SANITIZE_SCAN
+  #endif
+
+  #ifdef SASS_SCAN_SSE2
+
+  // index of the lowest set bit (mask must not be zero)
+  static inline unsigned first_bit(unsigned mask)
+  {
+    #if defined(_MSC_VER)
+      unsigned long index;
+      _BitScanForward(&index, mask);
+      return index;
+    #else
+      return __builtin_ctz(mask);
+    #endif
+  }
+
+  static inline unsigned chars_mask(__m128i v, __m128i a, __m128i b, __m128i c)
+  {
+    __m128i ab = _mm_or_si128(_mm_cmpeq_epi8(v, a), _mm_cmpeq_epi8(v, b));
+    __m128i cz = _mm_or_si128(_mm_cmpeq_epi8(v, c), _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+    return _mm_movemask_epi8(_mm_or_si128(ab, cz));
+  }
+
+  static inline unsigned no_spaces_mask(__m128i v)
+  {
+    __m128i blank = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    __m128i ctrl = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)),
+                                 _mm_cmplt_epi8(v, _mm_set1_epi8('\r' + 1)));
+    return _mm_movemask_epi8(_mm_or_si128(blank, ctrl)) ^ 0xFFFF;
+  }
+
+  SASS_NO_SANITIZE_SCAN
+  static const char* scan_chars_sse2(const char* src, char a, char b, char c)
+  {
+    __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b), vc = _mm_set1_epi8(c);
+    size_t offset = (uintptr_t) src & 15;
+    const char* block = src - offset;
+    unsigned mask = chars_mask(_mm_load_si128((const __m128i*) block), va, vb, vc) >> offset;
+    if (mask) return src + first_bit(mask);
+    while (true) {
+      block += 16;
+      mask = chars_mask(_mm_load_si128((const __m128i*) block), va, vb, vc);
+      if (mask) return block + first_bit(mask);
+    }
+  }
+
+  SASS_NO_SANITIZE_SCAN
+  static const char* scan_spaces_sse2(const char* src)
+  {
+    if (!is_space(*src)) return src;
+    size_t offset = (uintptr_t) src & 15;
+    const char* block = src - offset;
+    unsigned mask = no_spaces_mask(_mm_load_si128((const __m128i*) block)) >> offset;
+    if (mask) return src + first_bit(mask);
+    while (true) {
+      block += 16;
+      mask = no_spaces_mask(_mm_load_si128((const __m128i*) block));
+      if (mask) return block + first_bit(mask);
+    }
+  }
+
+  #endif
+
+  #ifdef SASS_SCAN_AVX2
+
+  __attribute__((target("avx2")))
+  static inline unsigned chars_mask(__m256i v, __m256i a, __m256i b, __m256i c)
+  {
+    __m256i ab = _mm256_or_si256(_mm256_cmpeq_epi8(v, a), _mm256_cmpeq_epi8(v, b));
+    __m256i cz = _mm256_or_si256(_mm256_cmpeq_epi8(v, c), _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+    return _mm256_movemask_epi8(_mm256_or_si256(ab, cz));
+  }
+
+  __attribute__((target("avx2")))
+  static inline unsigned no_spaces_mask(__m256i v)
+  {
+    __m256i blank = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+    __m256i ctrl = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('\t' - 1)),
+                                    _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), v));
+    return ~ (unsigned) _mm256_movemask_epi8(_mm256_or_si256(blank, ctrl));
+  }
+
+  SASS_NO_SANITIZE_SCAN __attribute__((target("avx2")))
+  static const char* scan_chars_avx2(const char* src, char a, char b, char c)
+  {
+    __m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b), vc = _mm256_set1_epi8(c);
+    size_t offset = (uintptr_t) src & 31;
+    const char* block = src - offset;
+    unsigned mask = chars_mask(_mm256_load_si256((const __m256i*) block), va, vb, vc) >> offset;
+    if (mask) return src + first_bit(mask);
+    while (true) {
+      block += 32;
+      mask = chars_mask(_mm256_load_si256((const __m256i*) block), va, vb, vc);
+      if (mask) return block + first_bit(mask);
+    }
+  }
+
+  SASS_NO_SANITIZE_SCAN __attribute__((target("avx2")))
+  static const char* scan_spaces_avx2(const char* src)
+  {
+    if (!is_space(*src)) return src;
+    size_t offset = (uintptr_t) src & 31;
+    const char* block = src - offset;
+    unsigned mask = no_spaces_mask(_mm256_load_si256((const __m256i*) block)) >> offset;
+    if (mask) return src + first_bit(mask);
+    while (true) {
+      block += 32;
+      mask = no_spaces_mask(_mm256_load_si256((const __m256i*) block));
+      if (mask) return block + first_bit(mask);
+    }
+  }
+
+  #endif
+
+  struct Char_Scanner {
+    Char_Scan_Impl impl;
+    const char* (*chars)(const char*, char, char, char);
+    const char* (*spaces)(const char*);
+  };
+
+  static const Char_Scanner scalar_scanner = { SCAN_SCALAR, scan_chars_scalar, scan_spaces_scalar };
+  #ifdef SASS_SCAN_SSE2
+  static const Char_Scanner sse2_scanner = { SCAN_SSE2, scan_chars_sse2, scan_spaces_sse2 };
+  #endif
+  #ifdef SASS_SCAN_AVX2
+  static const Char_Scanner avx2_scanner = { SCAN_AVX2, scan_chars_avx2, scan_spaces_avx2 };
+  #endif
+
+  // constant initialized, so it is usable before the selection below
+  // read by every compiling thread, hence atomic (relaxed is enough,
+  // the scanners it points to are immutable)
+  static std::atomic<const Char_Scanner*> scanner(&scalar_scanner);
+
+  bool use_char_scan(Char_Scan_Impl impl)
+  {
+    switch (impl) {
+      case SCAN_SCALAR:
+        scanner.store(&scalar_scanner, std::memory_order_relaxed);
+        return true;
+      #ifdef SASS_SCAN_SSE2
+      case SCAN_SSE2:
+        scanner.store(&sse2_scanner, std::memory_order_relaxed);
+        return true;
+      #endif
+      #ifdef SASS_SCAN_AVX2
+      case SCAN_AVX2:
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("avx2")) return false;
+        scanner.store(&avx2_scanner, std::memory_order_relaxed);
+        return true;
+      #endif
+      default:
+        return false;
+    }
+  }
+
+  Char_Scan_Impl char_scan_impl()
+  {
+    return scanner.load(std::memory_order_relaxed)->impl;
+  }
+
+  // pick the widest implementation once on startup
+  static bool selected = use_char_scan(SCAN_AVX2) || use_char_scan(SCAN_SSE2);
+
+  const char* scan_chars(const char* src, char a, char b, char c)
+  {
+    return scanner.load(std::memory_order_relaxed)->chars(src, a, b, c);
+  }
+
+  const char* scan_spaces(const char* src)
+  {
+    return scanner.load(std::memory_order_relaxed)->spaces(src);
+  }
+
+}
@@ -0,0 +1,32 @@
+#ifndef SASS_CHAR_SCAN_H
+#define SASS_CHAR_SCAN_H
+
+namespace Sass {
+
+  // Searches over null terminated sources, 16 or 32 chars at a time
+  // with SSE2 or AVX2 where available. The widest implementation the
+  // cpu supports is picked on startup, others are for testing only.
+  enum Char_Scan_Impl {
+    SCAN_SCALAR,
+    SCAN_SSE2,
+    SCAN_AVX2
+  };
+
+  // returns the first char that is a, b, c or the terminator
+  // pass a char more than once if you look for fewer of them
+  const char* scan_chars(const char* src, char a, char b, char c);
+
+  // returns the first char that is no space (see Prelexer::is_space)
+  const char* scan_spaces(const char* src);
+
+  // switches the implementation for all threads, compiles running
+  // at the same time may still finish a scan with the former one
+  // returns false if it is not supported by this cpu or build
+  bool use_char_scan(Char_Scan_Impl impl);
+
+  // implementation currently in use
+  Char_Scan_Impl char_scan_impl();
+
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include "listize.hpp"
 #include "extend.hpp"
 #include "remove_placeholders.hpp"
+#include "resolve.hpp"
 #include "functions.hpp"
 #include "sass_functions.hpp"
 #include "backtrace.hpp"
@@ -59,12 +60,16 @@ namespace Sass {
     return safe_path == "" ? "stdout" : safe_path;
   }
 
-  Context::Context(struct Sass_Context& c_ctx)
-  : CWD(File::get_cwd()),
+  Context::Context(struct Sass_Context& c_ctx, const Context* setup)
+  : Context(c_ctx, setup, setup ? setup->CWD : File::get_cwd())
+  { }
+
+  Context::Context(struct Sass_Context& c_ctx, const Context* setup, const std::string& cwd)
+  : CWD(cwd),
     c_options(c_ctx),
     entry_path(""),
     head_imports(0),
-    mem(Memory_Manager()),
+    mem(),
     plugins(),
     emitter(c_options),
 
@@ -73,6 +78,11 @@ namespace Sass {
     sheets(),
     subset_map(),
     import_stack(),
+    ascii_sources(true),
+
+    parse_cache(setup ? setup->parse_cache : 0),
+    cached_sheets(),
+    parse_stack(),
 
     c_headers               (std::vector<Sass_Importer_Entry>()),
     c_importers             (std::vector<Sass_Importer_Entry>()),
@@ -88,8 +98,16 @@ namespace Sass {
 
   {
 
+    // reuse the setup of a long lived context
+    // options of this context are added on top
+    if (setup) {
+      include_paths = setup->include_paths;
+      c_headers = setup->c_headers;
+      c_importers = setup->c_importers;
+      c_functions = setup->c_functions;
+    }
     // add cwd to include paths
-    include_paths.push_back(CWD);
+    else include_paths.push_back(CWD);
 
     // collect more paths from different options
     collect_include_paths(c_options.include_path);
@@ -130,10 +148,14 @@ namespace Sass {
 
   Context::~Context()
   {
+    // other compilations may use the cached sheets now
+    for (size_t i = 0; i < cached_sheets.size(); ++i) {
+      parse_cache->release(cached_sheets[i]);
+    }
     // resources were allocated by strdup or malloc
+    // or are files mapped into memory by read_resource
     for (size_t i = 0; i < resources.size(); ++i) {
-      free(resources[i].contents);
-      free(resources[i].srcmap);
+      free_resource(resources[i]);
     }
     // free all strings we kept alive during compiler execution
     for (size_t n = 0; n < strings.size(); ++n) free(strings[n]);
@@ -247,9 +269,42 @@ namespace Sass {
   }
 
 
+  // check out a sheet from the parse cache (or a new one to parse into)
+  // the sheet is given back when this context is destroyed
+  Parse_Cache::Sheet_Ptr Context::acquire_sheet(const std::string& key, const File::Stamp& stamp)
+  {
+    Parse_Cache::Sheet_Ptr sheet(parse_cache->acquire(key, stamp));
+    // resolve the imports again, since our include paths
+    // may differ or new files may take precedence now
+    bool valid = true;
+    if (sheet) for (size_t i = 0, S = sheet->imports.size(); valid && i < S; ++i) {
+      const std::vector<Include> resolved(find_includes(sheet->requests[i]));
+      valid = resolved.size() == 1 && resolved[0].abs_path == sheet->imports[i].abs_path;
+    }
+    if (sheet && !valid) {
+      parse_cache->release(sheet);
+      sheet.reset();
+    }
+    // parse it again
+    if (!sheet) sheet = parse_cache->create(key, stamp);
+    cached_sheets.push_back(sheet);
+    return sheet;
+  }
+
+  // whether the text may put non-ascii chars into the output
+  // either directly or through escapes like "\e9" (as unquoted)
+  static bool has_non_ascii_or_escape(const char* text)
+  {
+    for (; *text; ++ text) {
+      if (static_cast<unsigned char>(*text) >= 128 || *text == '\\') return true;
+    }
+    return false;
+  }
+
   // register include with resolved path and its content
   // memory of the resources will be freed by us on exit
-  void Context::register_resource(const Include& inc, const Resource& res, ParserState* prstate)
+  // the optional sheet holds the tree for the parse cache
+  void Context::register_resource(const Include& inc, const Resource& res, ParserState* prstate, const Parse_Cache::Sheet_Ptr& sheet)
   {
 
     // do not parse same resource twice
@@ -262,9 +317,11 @@ namespace Sass {
 
     // get index for this resource
     size_t idx = resources.size();
+    // cached trees need an index that is unique across all compilations
+    size_t source_id = sheet ? sheet->source_id : idx;
 
     // tell emitter about new resource
-    emitter.add_source_index(idx);
+    emitter.add_source_index(source_id);
 
     // put resources under our control
     // the memory will be freed later
@@ -286,12 +343,24 @@ namespace Sass {
     import_stack.push_back(import);
 
     // get pointer to the loaded content
-    const char* contents = resources[idx].contents;
+    const char* contents = sheet ? sheet->contents : resources[idx].contents;
+    // streamed output needs to know about the charset early
+    if (c_options.output_writer && ascii_sources && contents) {
+      ascii_sources = !has_non_ascii_or_escape(contents);
+    }
     // keep a copy of the path around (for parserstates)
     // ToDo: we clean it, but still not very elegant!?
-    strings.push_back(sass_copy_c_string(inc.abs_path.c_str()));
+    const char* path = 0;
+    if (sheet) {
+      if (!sheet->root) sheet->path = inc.abs_path;
+      path = sheet->path.c_str();
+    }
+    else {
+      strings.push_back(sass_copy_c_string(inc.abs_path.c_str()));
+      path = strings.back();
+    }
     // create the initial parser state from resource
-    ParserState pstate(strings.back(), contents, idx);
+    ParserState pstate(path, contents, source_id);
 
     // check existing import stack for possible recursion
     for (size_t i = 0; i < import_stack.size() - 2; ++i) {
@@ -310,13 +379,42 @@ namespace Sass {
       }
     }
 
-    // create a parser instance from the given c_str buffer
-    Parser p(Parser::from_c_str(contents, *this, pstate));
     // do not yet dispose these buffers
     sass_import_take_source(import);
     sass_import_take_srcmap(import);
-    // then parse the root block
-    Block* root = p.parse();
+    // root block of the resource
+    Block* root = 0;
+    // parsed by a previous compilation
+    if (sheet && sheet->root) {
+      root = sheet->root;
+      // register the imports as resolved by the parser
+      for (size_t i = 0, S = sheet->imports.size(); i < S; ++i) {
+        const Include& include(sheet->imports[i]);
+        if (!load_include(include, pstate)) {
+          error("File to import not found or unreadable: " + include.imp_path + ".\nParent style sheet: " + path, pstate);
+        }
+      }
+    }
+    else {
+      // create a parser instance from the given c_str buffer
+      Parser p(Parser::from_c_str(contents, *this, sheet ? sheet->mem : mem, pstate));
+      // find all lines once for the source positions
+      Line_Index lines(p.position, p.end);
+      p.lines = &lines;
+      // imports will be recorded on the sheet
+      parse_stack.push_back(sheet.get());
+      // then parse the root block
+      root = p.parse();
+      parse_stack.pop_back();
+      // bind variables with static scope
+      Resolve resolve;
+      if (root) root->perform(&resolve);
+      // share the tree with other compilations
+      if (sheet && root) {
+        sheet->root = root;
+        if (sheet->cacheable) parse_cache->insert(sheet);
+      }
+    }
     // delete memory of current stack frame
     sass_delete_import(import_stack.back());
     // remove current stack frame
@@ -351,17 +449,8 @@ namespace Sass {
 
     // process the resolved entry
     else if (resolved.size() == 1) {
-      bool use_cache = c_importers.size() == 0;
-      // use cache for the resource loading
-      if (use_cache && sheets.count(resolved[0].abs_path)) return resolved[0];
-      // try to read the content of the resolved file entry
-      // the memory buffer returned must be freed by us!
-      if (char* contents = read_file(resolved[0].abs_path)) {
-        // register the newly resolved file resource
-        register_resource(resolved[0], { contents, 0 }, &pstate);
-        // return resolved entry
-        return resolved[0];
-      }
+      // return resolved entry
+      if (load_include(resolved[0], pstate)) return resolved[0];
     }
 
     // nothing found
@@ -369,6 +458,37 @@ namespace Sass {
 
   }
 
+  // load and register a resolved file (unless it has been already)
+  bool Context::load_include(const Include& inc, ParserState pstate)
+  {
+    bool use_cache = c_importers.size() == 0;
+    // use cache for the resource loading
+    if (use_cache && sheets.count(inc.abs_path)) return true;
+    // use the tree parsed by a previous compilation
+    File::Stamp stamp;
+    if (use_cache && parse_cache && get_stamp(inc.abs_path, stamp)) {
+      Parse_Cache::Sheet_Ptr sheet(acquire_sheet(inc.abs_path, stamp));
+      // the sheet owns the source of its tree
+      if (!sheet->root) {
+        sheet->contents = read_file(inc.abs_path);
+        if (!sheet->contents) return false;
+      }
+      // register a copy of the source for us
+      register_resource(inc, { sass_copy_c_string(sheet->contents), 0 }, &pstate, sheet);
+      return true;
+    }
+    // try to read the content of the resolved file entry
+    // the memory buffer returned must be freed by us!
+    Resource res(read_resource(inc.abs_path));
+    if (res.contents) {
+      // register the newly resolved file resource
+      register_resource(inc, res, &pstate);
+      return true;
+    }
+    // nothing found
+    return false;
+  }
+
   void Context::import_url (Import* imp, std::string load_path, const std::string& ctx_path) {
 
     ParserState pstate(imp->pstate());
@@ -382,17 +502,21 @@ namespace Sass {
       // if (protocol.compare("file") && true) { }
     }
 
+    // nodes belong to the tree of the parsed sheet
+    Parse_Cache::Sheet* sheet = parse_stack.empty() ? 0 : parse_stack.back();
+    Memory_Manager& sheet_mem = sheet ? sheet->mem : mem;
+
     // add urls (protocol other than file) and urls without procotol to `urls` member
     // ToDo: if ctx_path is already a file resource, we should not add it here?
     if (imp->media_queries() || protocol != "file" || imp_path.substr(0, 2) == "//") {
-      imp->urls().push_back(SASS_MEMORY_NEW(mem, String_Quoted, imp->pstate(), load_path));
+      imp->urls().push_back(SASS_MEMORY_NEW(sheet_mem, String_Quoted, imp->pstate(), load_path));
     }
     else if (imp_path.length() > 4 && imp_path.substr(imp_path.length() - 4, 4) == ".css") {
-      String_Constant* loc = SASS_MEMORY_NEW(mem, String_Constant, pstate, unquote(load_path));
-      Argument* loc_arg = SASS_MEMORY_NEW(mem, Argument, pstate, loc);
-      Arguments* loc_args = SASS_MEMORY_NEW(mem, Arguments, pstate);
+      String_Constant* loc = SASS_MEMORY_NEW(sheet_mem, String_Constant, pstate, unquote(load_path));
+      Argument* loc_arg = SASS_MEMORY_NEW(sheet_mem, Argument, pstate, loc);
+      Arguments* loc_args = SASS_MEMORY_NEW(sheet_mem, Arguments, pstate);
       (*loc_args) << loc_arg;
-      Function_Call* new_url = SASS_MEMORY_NEW(mem, Function_Call, pstate, "url", loc_args);
+      Function_Call* new_url = SASS_MEMORY_NEW(sheet_mem, Function_Call, pstate, "url", loc_args);
       imp->urls().push_back(new_url);
     }
     else {
@@ -402,6 +526,11 @@ namespace Sass {
         error("File to import not found or unreadable: " + imp_path + ".\nParent style sheet: " + ctx_path, pstate);
       }
       imp->incs().push_back(include);
+      // registered again when the sheet is reused
+      if (sheet) {
+        sheet->imports.push_back(include);
+        sheet->requests.push_back(importer);
+      }
     }
 
   }
@@ -441,6 +570,7 @@ namespace Sass {
           size_t line = sass_import_get_error_line(include);
           size_t column = sass_import_get_error_column(include);
           const char *abs_path = sass_import_get_abs_path(include);
+          const char *cache_key = sass_import_get_cache_key(include);
           // handle error message passed back from custom importer
           // it may (or may not) override the line and column info
           if (const char* err_message = sass_import_get_error_message(include)) {
@@ -457,8 +587,23 @@ namespace Sass {
             Include include(importer, path_key);
             // attach information to AST node
             imp->incs().push_back(include);
+            // importer promised the same source for this key
+            if (parse_cache && cache_key) {
+              // keys are not related to files
+              File::Stamp stamp = { 0, 0 };
+              Parse_Cache::Sheet_Ptr sheet(acquire_sheet(std::string("importer:") + cache_key, stamp));
+              // the sheet keeps the returned buffers for its tree
+              if (!sheet->root) {
+                sheet->contents = source;
+                sheet->srcmap = srcmap;
+                source = sass_copy_c_string(source);
+                srcmap = srcmap ? sass_copy_c_string(srcmap) : 0;
+              }
+              // register the resource buffers
+              register_resource(include, { source, srcmap }, &pstate, sheet);
+            }
             // register the resource buffers
-            register_resource(include, { source, srcmap }, &pstate);
+            else register_resource(include, { source, srcmap }, &pstate);
           }
           // only a path was retuned
           // try to load it like normal
@@ -479,6 +624,10 @@ namespace Sass {
         sass_delete_import_list(includes);
         // set success flag
         has_import = true;
+        // the parse cache can not replay custom imports
+        if (!parse_stack.empty() && parse_stack.back()) {
+          parse_stack.back()->cacheable = false;
+        }
         // break out of loop
         if (only_one) break;
       }
@@ -491,6 +640,36 @@ namespace Sass {
   void register_function(Context&, Signature sig, Native_Function f, size_t arity, Env* env);
   void register_overload_stub(Context&, std::string name, Env* env);
   void register_built_in_functions(Context&, Env* env);
+
+  // only owns the nodes of the built-in definitions
+  // it never parses a source and needs no options
+  class Built_In_Context : public Context {
+  public:
+    Built_In_Context(struct Sass_Context& c_ctx)
+    : Context(c_ctx, 0, "")
+    { }
+    virtual Block* parse() { return 0; }
+  };
+
+  // built-in functions are the same for every compilation, so
+  // their signatures are only parsed once per process. Nothing
+  // writes to the definitions once they are registered, so all
+  // compilations (on any thread) can share them safely.
+  struct Built_Ins {
+    struct Sass_Context options;
+    Built_In_Context ctx;
+    Env env;
+    Built_Ins()
+    : options(), ctx(options), env()
+    { register_built_in_functions(ctx, &env); }
+  };
+
+  static const Env& built_in_environment()
+  {
+    // initialization of local statics is thread safe
+    static const Built_Ins built_ins;
+    return built_ins.env;
+  }
   void register_c_functions(Context&, Env* env, Sass_Function_List);
   void register_c_function(Context&, Env* env, Sass_Function_Entry);
 
@@ -498,28 +677,39 @@ namespace Sass {
   {
     // check for valid block
     if (!root) return 0;
+    // stream the output if requested
+    emitter.set_writer(c_options.output_writer, c_options.output_writer_cookie);
+    // custom functions may return any text
+    if (c_options.output_writer) emitter.prepare_stream(root, !ascii_sources || !c_functions.empty());
     // start the render process
     root->perform(&emitter);
     // finish emitter stream
     emitter.finalize();
     // get the resulting buffer from stream
-    OutputBuffer emitted = emitter.get_buffer();
+    OutputBuffer& emitted = emitter.get_buffer();
     // should we append a source map url?
     if (!c_options.omit_source_map_url) {
       // generate an embeded source map
       if (c_options.source_map_embed) {
-        emitted.buffer += linefeed;
-        emitted.buffer += format_embedded_source_map();
+        // write the encoded map right into its segment
+        emitted.append(linefeed);
+        format_embedded_source_map(emitted.tail.back());
       }
       // or just link the generated one
       else if (source_map_file != "") {
-        emitted.buffer += linefeed;
-        emitted.buffer += format_source_mapping_url(source_map_file);
+        emitted.append(linefeed + format_source_mapping_url(source_map_file));
       }
     }
+    // pass the rest to the writer
+    if (c_options.output_writer) {
+      emitter.write_output();
+      return sass_copy_c_string("");
+    }
     // create a copy of the resulting buffer string
     // this must be freed or taken over by implementor
-    return sass_copy_c_string(emitted.buffer.c_str());
+    char* result = (char*) sass_alloc_memory(emitted.size() + 1);
+    *emitted.write(result) = 0;
+    return result;
   }
 
   void Context::apply_custom_headers(Block* root, const char* ctx_path, ParserState pstate)
@@ -550,19 +740,19 @@ namespace Sass {
     std::string abs_path(rel2abs(input_path, CWD));
 
     // try to load the entry file
-    char* contents = read_file(abs_path);
+    Resource res(read_resource(abs_path));
 
     // alternatively also look inside each include path folder
     // I think this differs from ruby sass (IMO too late to remove)
-    for (size_t i = 0, S = include_paths.size(); contents == 0 && i < S; ++i) {
+    for (size_t i = 0, S = include_paths.size(); res.contents == 0 && i < S; ++i) {
       // build absolute path for this include path entry
       abs_path = rel2abs(input_path, include_paths[i]);
       // try to load the resulting path
-      contents = read_file(abs_path);
+      res = read_resource(abs_path);
     }
 
     // abort early if no content could be loaded (various reasons)
-    if (!contents) throw "File to read not found or unreadable: " + input_path;
+    if (!res.contents) throw "File to read not found or unreadable: " + input_path;
 
     // store entry path
     entry_path = abs_path;
@@ -571,14 +761,14 @@ namespace Sass {
     Sass_Import_Entry import = sass_make_import(
       input_path.c_str(),
       entry_path.c_str(),
-      contents,
+      res.contents,
       0
     );
     // add the entry to the stack
     import_stack.push_back(import);
 
     // create the source entry for file entry
-    register_resource({{ input_path, "." }, abs_path }, { contents, 0 });
+    register_resource({{ input_path, "." }, abs_path }, res);
 
     // create root ast tree node
     return compile();
@@ -640,7 +830,7 @@ namespace Sass {
 
     Env global; // create root environment
     // register built-in functions on env
-    register_built_in_functions(*this, &global);
+    global.copy_definitions(built_in_environment());
     // register custom functions (defined via C-API)
     for (size_t i = 0, S = c_functions.size(); i < S; ++i)
     { register_c_function(*this, &global, c_functions[i]); }
@@ -675,16 +865,11 @@ namespace Sass {
   }
   // EO compile
 
-  std::string Context::format_embedded_source_map()
+  void Context::format_embedded_source_map(std::string& buffer)
   {
-    std::string map = emitter.render_srcmap(*this);
-    std::istringstream is( map );
-    std::ostringstream buffer;
-    base64::encoder E;
-    E.encode(is, buffer);
-    std::string url = "data:application/json;base64," + buffer.str();
-    url.erase(url.size() - 1);
-    return "/*# sourceMappingURL=" + url + " */";
+    buffer += "/*# sourceMappingURL=data:application/json;base64,";
+    emitter.render_srcmap(*this, buffer, true);
+    buffer += " */";
   }
 
   std::string Context::format_source_mapping_url(const std::string& file)
@@ -721,7 +906,7 @@ namespace Sass {
   {
     Definition* def = make_native_function(sig, f, ctx);
     def->environment(env);
-    (*env)[def->name() + "[f]"] = def;
+    env->set_definition(def->name() + "[f]", def);
   }
 
   void register_function(Context& ctx, Signature sig, Native_Function f, size_t arity, Env* env)
@@ -730,7 +915,7 @@ namespace Sass {
     std::stringstream ss;
     ss << def->name() << "[f]" << arity;
     def->environment(env);
-    (*env)[ss.str()] = def;
+    env->set_definition(ss.str(), def);
   }
 
   void register_overload_stub(Context& ctx, std::string name, Env* env)
@@ -742,7 +927,7 @@ namespace Sass {
                                        0,
                                        0,
                                        true);
-    (*env)[name + "[f]"] = stub;
+    env->set_definition(name + "[f]", stub);
   }
 
 
@@ -858,7 +1043,7 @@ namespace Sass {
   {
     Definition* def = make_c_function(descr, ctx);
     def->environment(env);
-    (*env)[def->name() + "[f]"] = def;
+    env->set_definition(def->name() + "[f]", def);
   }
 
 }
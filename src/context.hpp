@@ -18,6 +18,7 @@
 #include "subset_map.hpp"
 #include "output.hpp"
 #include "plugins.hpp"
+#include "parse_cache.hpp"
 #include "file.hpp"
 
 
@@ -52,6 +53,16 @@ namespace Sass {
     std::map<const std::string, const StyleSheet> sheets;
     Subset_Map<std::string, std::pair<Sequence_Selector*, SimpleSequence_Selector*> > subset_map;
     std::vector<Sass_Import_Entry> import_stack;
+    // no loaded source had non-ascii bytes or escapes
+    // (only checked when the output is streamed)
+    bool ascii_sources;
+
+    // parsed sheets shared with other compilations (optional)
+    Parse_Cache* parse_cache;
+    // sheets checked out from the parse cache
+    std::vector<Parse_Cache::Sheet_Ptr> cached_sheets;
+    // sheets currently being parsed (null if not cached)
+    std::vector<Parse_Cache::Sheet*> parse_stack;
 
     struct Sass_Compiler* c_compiler;
 
@@ -86,15 +97,22 @@ namespace Sass {
     const std::string source_map_root; // path for sourceRoot property (pass-through)
 
     virtual ~Context();
-    Context(struct Sass_Context&);
+    // setup is copied from another context if given
+    Context(struct Sass_Context&, const Context* setup = 0);
+  protected:
+    // contexts that never resolve paths skip the cwd lookup
+    Context(struct Sass_Context&, const Context* setup, const std::string& cwd);
+  public:
     virtual Block* parse() = 0;
     virtual Block* compile();
     virtual char* render(Block* root);
     virtual char* render_srcmap();
 
-    void register_resource(const Include&, const Resource&, ParserState* = 0);
+    void register_resource(const Include&, const Resource&, ParserState* = 0, const Parse_Cache::Sheet_Ptr& = Parse_Cache::Sheet_Ptr());
     std::vector<Include> find_includes(const Importer& import);
     Include load_import(const Importer&, ParserState pstate);
+    bool load_include(const Include&, ParserState pstate);
+    Parse_Cache::Sheet_Ptr acquire_sheet(const std::string& key, const File::Stamp& stamp);
 
     Sass_Output_Style output_style() { return c_options.output_style; };
     std::vector<std::string> get_included_files(bool skip = false, size_t headers = 0);
@@ -104,7 +122,8 @@ namespace Sass {
     void collect_plugin_paths(string_list* paths_array);
     void collect_include_paths(const char* paths_str);
     void collect_include_paths(string_list* paths_array);
-    std::string format_embedded_source_map();
+    // appends the comment with the encoded map to buffer
+    void format_embedded_source_map(std::string& buffer);
     std::string format_source_mapping_url(const std::string& out_path);
 
 
@@ -119,8 +138,8 @@ namespace Sass {
 
   class File_Context : public Context {
   public:
-    File_Context(struct Sass_File_Context& ctx)
-    : Context(ctx)
+    File_Context(struct Sass_File_Context& ctx, const Context* setup = 0)
+    : Context(ctx, setup)
     { }
     virtual ~File_Context();
     virtual Block* parse();
@@ -130,8 +149,8 @@ namespace Sass {
   public:
     char* source_c_str;
     char* srcmap_c_str;
-    Data_Context(struct Sass_Data_Context& ctx)
-    : Context(ctx)
+    Data_Context(struct Sass_Data_Context& ctx, const Context* setup = 0)
+    : Context(ctx, setup)
     {
       source_c_str       = ctx.source_string;
       srcmap_c_str       = ctx.srcmap_string;
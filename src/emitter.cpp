@@ -1,4 +1,6 @@
 #include "sass.hpp"
+#include <cstring>
+#include <algorithm>
 #include "util.hpp"
 #include "context.hpp"
 #include "output.hpp"
@@ -9,6 +11,9 @@ namespace Sass {
 
   Emitter::Emitter(struct Sass_Output_Options& opt)
   : wbuf(),
+    writer(0),
+    writer_cookie(0),
+    written(0),
     opt(opt),
     indentation(0),
     scheduled_space(0),
@@ -26,7 +31,7 @@ namespace Sass {
   // return buffer as string
   std::string Emitter::get_buffer(void)
   {
-    return wbuf.buffer;
+    return wbuf.str();
   }
 
   Sass_Output_Style Emitter::output_style(void) const
@@ -42,6 +47,9 @@ namespace Sass {
   std::string Emitter::render_srcmap(Context &ctx)
   { return wbuf.smap.render_srcmap(ctx); }
 
+  void Emitter::render_srcmap(Context &ctx, std::string& out, bool encode_base64)
+  { wbuf.smap.render_srcmap(ctx, out, encode_base64); }
+
   void Emitter::set_filename(const std::string& str)
   { wbuf.smap.file = str; }
 
@@ -91,18 +99,60 @@ namespace Sass {
     }
   }
 
+  void Emitter::set_writer(Sass_Output_Writer writer, void* cookie)
+  {
+    this->writer = writer;
+    this->writer_cookie = cookie;
+  }
+
+  void Emitter::write_segment(const std::string& segment)
+  {
+    if (segment.empty()) return;
+    writer(segment.data(), segment.size(), writer_cookie);
+    written += segment.size();
+  }
+
+  void Emitter::write_output(void)
+  {
+    if (!writer) return;
+    // head segments are stored in reverse
+    for (size_t i = wbuf.head.size(); i > 0; --i) {
+      write_segment(wbuf.head[i - 1]);
+    }
+    write_segment(wbuf.buffer);
+    for (const std::string& segment : wbuf.tail) {
+      write_segment(segment);
+    }
+    wbuf.head.clear();
+    // keeps the capacity for the next chunk
+    wbuf.buffer.clear();
+    wbuf.tail.clear();
+  }
+
+  void Emitter::flush_output(void)
+  {
+    // keep the end of the buffer, so we can still
+    // look behind (e.g. for a trailing linefeed)
+    size_t keep = std::max<size_t>(1, std::strlen(opt.linefeed));
+    if (wbuf.buffer.size() <= keep) return;
+    std::string rest(wbuf.buffer, wbuf.buffer.size() - keep);
+    wbuf.buffer.resize(wbuf.buffer.size() - keep);
+    write_output();
+    wbuf.buffer += rest;
+  }
+
   // prepend some text or token to the buffer
   void Emitter::prepend_output(const OutputBuffer& output)
   {
     wbuf.smap.prepend(output);
-    wbuf.buffer = output.buffer + wbuf.buffer;
+    wbuf.prepend(output);
   }
 
   // prepend some text or token to the buffer
   void Emitter::prepend_string(const std::string& text)
   {
     wbuf.smap.prepend(Offset(text));
-    wbuf.buffer = text + wbuf.buffer;
+    wbuf.prepend(text);
   }
 
   // append some text or token to the buffer
@@ -125,6 +175,11 @@ namespace Sass {
       // account for data in source-maps
       wbuf.smap.append(Offset(text));
     }
+
+    // pass a complete chunk on
+    if (writer && wbuf.buffer.size() >= OUTPUT_CHUNK_SIZE) {
+      flush_output();
+    }
   }
 
   // append some white-space only text
@@ -4,12 +4,16 @@
 #include <string>
 #include "sass.hpp"
 #include "sass/base.h"
+#include "sass/context.h"
 #include "source_map.hpp"
 #include "ast_fwd_decl.hpp"
 
 namespace Sass {
   class Context;
 
+  // streamed output is passed on in chunks of this size
+  const size_t OUTPUT_CHUNK_SIZE = 64 * 1024;
+
   class Emitter {
 
     public:
@@ -18,6 +22,12 @@ namespace Sass {
 
     protected:
       OutputBuffer wbuf;
+      // optional writer for streamed output
+      Sass_Output_Writer writer;
+      void* writer_cookie;
+      // bytes passed to the writer so far
+      size_t written;
+      void write_segment(const std::string& segment);
     public:
       const std::string& buffer(void) { return wbuf.buffer; }
       const SourceMap smap(void) { return wbuf.smap; }
@@ -29,6 +39,7 @@ namespace Sass {
       void add_close_mapping(const AST_Node* node);
       void schedule_mapping(const AST_Node* node);
       std::string render_srcmap(Context &ctx);
+      void render_srcmap(Context &ctx, std::string& out, bool encode_base64);
       ParserState remap(const ParserState& pstate);
 
     public:
@@ -59,6 +70,12 @@ namespace Sass {
       Sass_Output_Style output_style(void) const;
       // add outstanding linefeed
       void finalize(bool final = true);
+      // stream the output to the writer from now on
+      void set_writer(Sass_Output_Writer writer, void* cookie);
+      // pass everything buffered to the writer
+      void write_output(void);
+      // called once a chunk is complete
+      virtual void flush_output(void);
       // flush scheduled space/linefeed
       void flush_schedules(void);
       // prepend some text or token to the buffer
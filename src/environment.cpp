@@ -1,30 +1,121 @@
 #include "sass.hpp"
+#include <atomic>
 #include "ast.hpp"
 #include "environment.hpp"
 
 namespace Sass {
 
+  // double the capacity and re-insert all entries
+  template <typename T>
+  void Environment_Frame<T>::grow()
+  {
+    std::vector<Entry> old;
+    old.swap(entries_);
+    entries_.resize(old.empty() ? 8 : old.size() * 2, Entry());
+    for (size_t n = 0, S = old.size(); n < S; ++n) {
+      if (old[n].key == 0) continue;
+      size_t i = index(old[n].key);
+      while (entries_[i].key) i = (i + 1) & (entries_.size() - 1);
+      entries_[i] = old[n];
+    }
+  }
+
+  template <typename T>
+  T& Environment_Frame<T>::operator[](Symbol key)
+  {
+    if (T* value = find(key)) return *value;
+    // keep the load factor below one half
+    if ((size_ + 1) * 2 > entries_.size()) grow();
+    size_t i = index(key);
+    while (entries_[i].key) i = (i + 1) & (entries_.size() - 1);
+    entries_[i].key = key;
+    entries_[i].value = T();
+    ++ size_;
+    return entries_[i].value;
+  }
+
+  template <typename T>
+  void Environment_Frame<T>::erase(Symbol key)
+  {
+    if (size_ == 0) return;
+    size_t mask = entries_.size() - 1;
+    size_t i = index(key);
+    while (entries_[i].key != key) {
+      if (entries_[i].key == 0) return;
+      i = (i + 1) & mask;
+    }
+    // shift following entries back into the hole
+    // so we never need tombstones when probing
+    for (size_t j = (i + 1) & mask; entries_[j].key; j = (j + 1) & mask) {
+      size_t home = index(entries_[j].key);
+      if (((j - home) & mask) >= ((j - i) & mask)) {
+        entries_[i] = entries_[j];
+        i = j;
+      }
+    }
+    entries_[i] = Entry();
+    -- size_;
+  }
+
+  // bumped on every registered definition
+  static std::atomic<size_t> definitions_counter(1);
+
   template <typename T>
   Environment<T>::Environment(bool is_shadow)
-  : local_frame_(std::map<std::string, T>()),
-    parent_(0), is_shadow_(false)
+  : local_frame_(),
+    parent_(0), is_shadow_(false),
+    definitions_(0)
   { }
   template <typename T>
   Environment<T>::Environment(Environment<T>* env, bool is_shadow)
-  : local_frame_(std::map<std::string, T>()),
-    parent_(env), is_shadow_(is_shadow)
+  : local_frame_(),
+    parent_(env), is_shadow_(is_shadow),
+    definitions_(env ? env->definitions_ : 0)
   { }
   template <typename T>
   Environment<T>::Environment(Environment<T>& env, bool is_shadow)
-  : local_frame_(std::map<std::string, T>()),
-    parent_(&env), is_shadow_(is_shadow)
+  : local_frame_(),
+    parent_(&env), is_shadow_(is_shadow),
+    definitions_(env.definitions_)
   { }
 
   // link parent to create a stack
   template <typename T>
-  void Environment<T>::link(Environment& env) { parent_ = &env; }
+  void Environment<T>::link(Environment& env) { link(&env); }
+  template <typename T>
+  void Environment<T>::link(Environment* env)
+  {
+    parent_ = env;
+    if (definitions_ != this) definitions_ = env ? env->definitions_ : 0;
+  }
+
+  // definitions are only ever added to the innermost
+  // frame, so no other frame can have a stale pointer
+  template <typename T>
+  void Environment<T>::set_definition(const std::string& key, T val)
+  {
+    set_local(key, val);
+    definitions_ = this;
+    ++ definitions_counter;
+  }
+
   template <typename T>
-  void Environment<T>::link(Environment* env) { parent_ = env; }
+  void Environment<T>::copy_definitions(const Environment& env)
+  {
+    typedef typename Environment_Frame<T>::Entry Entry;
+    const std::vector<Entry>& entries = env.local_frame_.entries();
+    for (size_t i = 0, S = entries.size(); i < S; ++i) {
+      if (entries[i].key) local_frame_[entries[i].key] = entries[i].value;
+    }
+    definitions_ = this;
+    ++ definitions_counter;
+  }
+
+  template <typename T>
+  size_t Environment<T>::definitions_stamp()
+  {
+    return definitions_counter;
+  }
 
   // this is used to find the global frame
   // which is the second last on the stack
@@ -45,26 +136,26 @@ namespace Sass {
   }
 
   template <typename T>
-  std::map<std::string, T>& Environment<T>::local_frame() {
+  Environment_Frame<T>& Environment<T>::local_frame() {
     return local_frame_;
   }
 
   template <typename T>
-  bool Environment<T>::has_local(const std::string& key) const
-  { return local_frame_.find(key) != local_frame_.end(); }
+  bool Environment<T>::has_local(Symbol key) const
+  { return local_frame_.find(key) != 0; }
 
   template <typename T>
-  T& Environment<T>::get_local(const std::string& key)
+  T& Environment<T>::get_local(Symbol key)
   { return local_frame_[key]; }
 
   template <typename T>
-  void Environment<T>::set_local(const std::string& key, T val)
+  void Environment<T>::set_local(Symbol key, T val)
   {
     local_frame_[key] = val;
   }
 
   template <typename T>
-  void Environment<T>::del_local(const std::string& key)
+  void Environment<T>::del_local(Symbol key)
   { local_frame_.erase(key); }
 
   template <typename T>
@@ -78,25 +169,25 @@ namespace Sass {
   }
 
   template <typename T>
-  bool Environment<T>::has_global(const std::string& key)
+  bool Environment<T>::has_global(Symbol key)
   { return global_env()->has(key); }
 
   template <typename T>
-  T& Environment<T>::get_global(const std::string& key)
+  T& Environment<T>::get_global(Symbol key)
   { return (*global_env())[key]; }
 
   template <typename T>
-  void Environment<T>::set_global(const std::string& key, T val)
+  void Environment<T>::set_global(Symbol key, T val)
   {
     global_env()->local_frame_[key] = val;
   }
 
   template <typename T>
-  void Environment<T>::del_global(const std::string& key)
+  void Environment<T>::del_global(Symbol key)
   { global_env()->local_frame_.erase(key); }
 
   template <typename T>
-  Environment<T>* Environment<T>::lexical_env(const std::string& key)
+  Environment<T>* Environment<T>::lexical_env(Symbol key)
   {
     Environment* cur = this;
     while (cur) {
@@ -112,7 +203,7 @@ namespace Sass {
   // move down the stack but stop before we
   // reach the global frame (is not included)
   template <typename T>
-  bool Environment<T>::has_lexical(const std::string& key) const
+  bool Environment<T>::has_lexical(Symbol key) const
   {
     auto cur = this;
     while (cur->is_lexical()) {
@@ -126,7 +217,7 @@ namespace Sass {
   // either update already existing lexical value
   // or if flag is set, we create one if no lexical found
   template <typename T>
-  void Environment<T>::set_lexical(const std::string& key, T val)
+  void Environment<T>::set_lexical(Symbol key, T val)
   {
     auto cur = this; bool shadow = false;
     while (cur->is_lexical() || shadow) {
@@ -143,7 +234,7 @@ namespace Sass {
   // look on the full stack for key
   // include all scopes available
   template <typename T>
-  bool Environment<T>::has(const std::string& key) const
+  bool Environment<T>::has(Symbol key) const
   {
     auto cur = this;
     while (cur) {
@@ -157,7 +248,7 @@ namespace Sass {
 
   // use array access for getter and setter functions
   template <typename T>
-  T& Environment<T>::operator[](const std::string& key)
+  T& Environment<T>::operator[](Symbol key)
   {
     auto cur = this;
     while (cur) {
@@ -169,6 +260,103 @@ namespace Sass {
     return get_local(key);
   }
 
+  // look directly in the frame depth levels up the stack
+  // used for variables with static bindings (see resolve)
+  template <typename T>
+  T* Environment<T>::find_local(Symbol key, size_t depth)
+  {
+    Environment* cur = this;
+    while (cur && depth) {
+      cur = cur->parent_;
+      -- depth;
+    }
+    return cur ? cur->local_frame_.find(key) : 0;
+  }
+
+  // string based lookups never add to the symbol table
+  // a name that was never interned can not be in a frame
+  // getters that create a missing entry intern the key
+
+  template <typename T>
+  bool Environment<T>::has_local(const std::string& key) const
+  {
+    Symbol sym = Symbol_Table::find(key);
+    return sym && has_local(sym);
+  }
+
+  template <typename T>
+  T& Environment<T>::get_local(const std::string& key)
+  {
+    Symbol sym = Symbol_Table::find(key);
+    return get_local(sym ? sym : Symbol_Table::intern(key));
+  }
+
+  template <typename T>
+  void Environment<T>::set_local(const std::string& key, T val)
+  { set_local(Symbol_Table::intern(key), val); }
+
+  template <typename T>
+  void Environment<T>::del_local(const std::string& key)
+  {
+    if (Symbol sym = Symbol_Table::find(key)) del_local(sym);
+  }
+
+  template <typename T>
+  bool Environment<T>::has_global(const std::string& key)
+  {
+    Symbol sym = Symbol_Table::find(key);
+    return sym && has_global(sym);
+  }
+
+  template <typename T>
+  T& Environment<T>::get_global(const std::string& key)
+  {
+    Symbol sym = Symbol_Table::find(key);
+    return get_global(sym ? sym : Symbol_Table::intern(key));
+  }
+
+  template <typename T>
+  void Environment<T>::set_global(const std::string& key, T val)
+  { set_global(Symbol_Table::intern(key), val); }
+
+  template <typename T>
+  void Environment<T>::del_global(const std::string& key)
+  {
+    if (Symbol sym = Symbol_Table::find(key)) del_global(sym);
+  }
+
+  template <typename T>
+  Environment<T>* Environment<T>::lexical_env(const std::string& key)
+  {
+    Symbol sym = Symbol_Table::find(key);
+    return sym ? lexical_env(sym) : this;
+  }
+
+  template <typename T>
+  bool Environment<T>::has_lexical(const std::string& key) const
+  {
+    Symbol sym = Symbol_Table::find(key);
+    return sym && has_lexical(sym);
+  }
+
+  template <typename T>
+  void Environment<T>::set_lexical(const std::string& key, T val)
+  { set_lexical(Symbol_Table::intern(key), val); }
+
+  template <typename T>
+  bool Environment<T>::has(const std::string& key) const
+  {
+    Symbol sym = Symbol_Table::find(key);
+    return sym && has(sym);
+  }
+
+  template <typename T>
+  T& Environment<T>::operator[](const std::string& key)
+  {
+    Symbol sym = Symbol_Table::find(key);
+    return (*this)[sym ? sym : Symbol_Table::intern(key)];
+  }
+
   #ifdef DEBUG
   template <typename T>
   size_t Environment<T>::print(std::string prefix)
@@ -176,10 +364,13 @@ namespace Sass {
     size_t indent = 0;
     if (parent_) indent = parent_->print(prefix) + 1;
     std::cerr << prefix << std::string(indent, ' ') << "== " << this << std::endl;
-    for (typename std::map<std::string, T>::iterator i = local_frame_.begin(); i != local_frame_.end(); ++i) {
-      if (!ends_with(i->first, "[f]") && !ends_with(i->first, "[f]4") && !ends_with(i->first, "[f]2")) {
-        std::cerr << prefix << std::string(indent, ' ') << i->first << " "  << i->second;
-        if (Value* val = dynamic_cast<Value*>(i->second))
+    typedef typename Environment_Frame<T>::Entry Entry;
+    for (const Entry& entry : local_frame_.entries()) {
+      if (entry.key == 0) continue;
+      const std::string& key(Symbol_Table::name(entry.key));
+      if (!ends_with(key, "[f]") && !ends_with(key, "[f]4") && !ends_with(key, "[f]2")) {
+        std::cerr << prefix << std::string(indent, ' ') << key << " "  << entry.value;
+        if (Value* val = dynamic_cast<Value*>(entry.value))
         { std::cerr << " : " << val->to_string(); }
         std::cerr << std::endl;
       }
@@ -189,6 +380,7 @@ namespace Sass {
   #endif
 
   // compile implementation for AST_Node
+  template class Environment_Frame<AST_Node*>;
   template class Environment<AST_Node*>;
 
 }
@@ -2,23 +2,63 @@
 #define SASS_ENVIRONMENT_H
 
 #include <string>
-#include <map>
+#include <vector>
 
 #include "ast_fwd_decl.hpp"
 #include "ast_def_macros.hpp"
-#include "memory_manager.hpp"
+#include "symbol_table.hpp"
 
 namespace Sass {
 
+  // flat hash table to store the values of a frame
+  // open addressing with linear probing, most frames
+  // only hold a handful of entries (or none at all)
+  template <typename T>
+  class Environment_Frame {
+  public:
+    struct Entry {
+      Symbol key;
+      T value;
+    };
+  private:
+    // capacity is zero or a power of two
+    std::vector<Entry> entries_;
+    size_t size_;
+  private:
+    size_t index(Symbol key) const
+    { return (key * 2654435761u) & (entries_.size() - 1); }
+    void grow();
+  public:
+    Environment_Frame() : entries_(), size_(0) { }
+    size_t size() const { return size_; }
+    // returns 0 if the key is not in the frame
+    T* find(Symbol key)
+    {
+      if (size_ == 0) return 0;
+      for (size_t i = index(key); ; i = (i + 1) & (entries_.size() - 1)) {
+        if (entries_[i].key == key) return &entries_[i].value;
+        if (entries_[i].key == 0) return 0;
+      }
+    }
+    const T* find(Symbol key) const
+    { return const_cast<Environment_Frame*>(this)->find(key); }
+    // find or create the entry for key
+    T& operator[](Symbol key);
+    void erase(Symbol key);
+    // entries with a zero key are empty
+    const std::vector<Entry>& entries() const { return entries_; }
+  };
+
   template <typename T>
   class Environment {
-    // TODO: test with map
-    std::map<std::string, T> local_frame_;
+    Environment_Frame<T> local_frame_;
     ADD_PROPERTY(Environment*, parent)
     ADD_PROPERTY(bool, is_shadow)
+    // closest frame on the stack (maybe this) that holds
+    // registered definitions (these frames are rather rare)
+    Environment* definitions_;
 
   public:
-    Memory_Manager mem;
     Environment(bool is_shadow = false);
     Environment(Environment* env, bool is_shadow = false);
     Environment(Environment& env, bool is_shadow = false);
@@ -37,9 +77,20 @@ namespace Sass {
     // I guess we store functions etc. there
     bool is_global() const;
 
+    // frames between us and this one hold no definitions
+    // so all function lookups from here give the same result
+    Environment* definitions() const { return definitions_; }
+
+    // register a function or mixin definition on the current frame
+    void set_definition(const std::string& key, T val);
+    // register all entries of another frame as definitions
+    void copy_definitions(const Environment& env);
+    // increased whenever any definition is registered
+    static size_t definitions_stamp();
+
     // scope operates on the current frame
 
-    std::map<std::string, T>& local_frame();
+    Environment_Frame<T>& local_frame();
 
     bool has_local(const std::string& key) const;
 
@@ -83,6 +134,25 @@ namespace Sass {
     // use array access for getter and setter functions
     T& operator[](const std::string& key);
 
+    // same as above, but with already interned keys
+    bool has_local(Symbol key) const;
+    T& get_local(Symbol key);
+    void set_local(Symbol key, T val);
+    void del_local(Symbol key);
+    Environment* lexical_env(Symbol key);
+    bool has_global(Symbol key);
+    T& get_global(Symbol key);
+    void set_global(Symbol key, T val);
+    void del_global(Symbol key);
+    bool has_lexical(Symbol key) const;
+    void set_lexical(Symbol key, T val);
+    bool has(Symbol key) const;
+    T& operator[](Symbol key);
+
+    // look directly in the frame depth levels up the stack
+    // returns 0 if the frame does not hold the key
+    T* find_local(Symbol key, size_t depth);
+
     #ifdef DEBUG
     size_t print(std::string prefix = "");
     #endif
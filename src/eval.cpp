@@ -80,7 +80,7 @@ namespace Sass {
   Expression* Eval::operator()(Assignment* a)
   {
     Env* env = exp.environment();
-    std::string var(a->variable());
+    Symbol var(a->symbol());
     if (a->is_global()) {
       if (a->is_default()) {
         if (env->has_global(var)) {
@@ -132,6 +132,11 @@ namespace Sass {
         env->set_local(var, a->value()->perform(this));
       }
     }
+    else if (a->depth() >= 0 && env->find_local(var, a->depth())) {
+      // update the frame found by the resolver
+      Expression* value = a->value()->perform(this);
+      *env->find_local(var, a->depth()) = value;
+    }
     else {
       env->set_lexical(var, a->value()->perform(this));
     }
@@ -158,7 +163,7 @@ namespace Sass {
   // But iteration vars are reset afterwards
   Expression* Eval::operator()(For* f)
   {
-    std::string variable(f->variable());
+    Symbol variable(Symbol_Table::intern(f->variable()));
     Expression* low = f->lower_bound()->perform(this);
     if (low->concrete_type() != Expression::NUMBER) {
       throw Exception::TypeMismatch(*low, "integer");
@@ -178,19 +183,18 @@ namespace Sass {
     }
     double start = sass_start->value();
     double end = sass_end->value();
-    // only create iterator once in this environment
     Env env(environment(), true);
     exp.env_stack.push_back(&env);
-    Number* it = SASS_MEMORY_NEW(env.mem, Number, low->pstate(), start, sass_end->unit());
-    env.set_local(variable, it);
     Block* body = f->block();
     Expression* val = 0;
+    // create a new iterator for each step, since
+    // the value may be shared by other variables
     if (start < end) {
       if (f->is_inclusive()) ++end;
       for (double i = start;
            i < end;
            ++i) {
-        it->value(i);
+        Number* it = SASS_MEMORY_NEW(ctx.mem, Number, low->pstate(), i, sass_end->unit());
         env.set_local(variable, it);
         val = body->perform(this);
         if (val) break;
@@ -200,7 +204,7 @@ namespace Sass {
       for (double i = start;
            i > end;
            --i) {
-        it->value(i);
+        Number* it = SASS_MEMORY_NEW(ctx.mem, Number, low->pstate(), i, sass_end->unit());
         env.set_local(variable, it);
         val = body->perform(this);
         if (val) break;
@@ -214,7 +218,10 @@ namespace Sass {
   // But iteration vars are reset afterwards
   Expression* Eval::operator()(Each* e)
   {
-    std::vector<std::string> variables(e->variables());
+    std::vector<std::string> names(e->variables());
+    std::vector<Symbol> variables(names.size());
+    for (size_t i = 0, L = names.size(); i < L; ++i)
+    { variables[i] = Symbol_Table::intern(names[i]); }
     Expression* expr = e->list()->perform(this);
     Env env(environment(), true);
     exp.env_stack.push_back(&env);
@@ -326,9 +333,9 @@ namespace Sass {
     Env* env = exp.environment();
 
     // try to use generic function
-    if (env->has("@warn[f]")) {
+    if (env->has(Symbols::warn_fn)) {
 
-      Definition* def = static_cast<Definition*>((*env)["@warn[f]"]);
+      Definition* def = static_cast<Definition*>((*env)[Symbols::warn_fn]);
       // Block*          body   = def->block();
       // Native_Function func   = def->native_function();
       Sass_Function_Entry c_function = def->c_function();
@@ -362,9 +369,9 @@ namespace Sass {
     Env* env = exp.environment();
 
     // try to use generic function
-    if (env->has("@error[f]")) {
+    if (env->has(Symbols::error_fn)) {
 
-      Definition* def = static_cast<Definition*>((*env)["@error[f]"]);
+      Definition* def = static_cast<Definition*>((*env)[Symbols::error_fn]);
       // Block*          body   = def->block();
       // Native_Function func   = def->native_function();
       Sass_Function_Entry c_function = def->c_function();
@@ -395,9 +402,9 @@ namespace Sass {
     Env* env = exp.environment();
 
     // try to use generic function
-    if (env->has("@debug[f]")) {
+    if (env->has(Symbols::debug_fn)) {
 
-      Definition* def = static_cast<Definition*>((*env)["@debug[f]"]);
+      Definition* def = static_cast<Definition*>((*env)[Symbols::debug_fn]);
       // Block*          body   = def->block();
       // Native_Function func   = def->native_function();
       Sass_Function_Entry c_function = def->c_function();
@@ -438,7 +445,10 @@ namespace Sass {
         Expression* key = (*l)[i+0]->perform(this);
         Expression* val = (*l)[i+1]->perform(this);
         // make sure the color key never displays its real name
-        key->is_delayed(true); // verified
+        if (!key->is_delayed()) {
+          key = copy_value(key);
+          key->is_delayed(true); // verified
+        }
         *lm << std::make_pair(key, val);
       }
       if (lm->has_duplicate_key()) {
@@ -529,10 +539,12 @@ namespace Sass {
 
 
     // don't eval delayed expressions (the '/' when used as a separator)
+    // the parsed tree may be shared, so evaluate into a copy
     if (!force && op_type == Sass_OP::DIV && b->is_delayed()) {
-      b->right(b->right()->perform(this));
-      b->left(b->left()->perform(this));
-      return b;
+      Binary_Expression* ex = SASS_MEMORY_NEW(ctx.mem, Binary_Expression, *b);
+      ex->right(b->right()->perform(this));
+      ex->left(b->left()->perform(this));
+      return ex;
     }
 
     Expression* lhs = b->left();
@@ -583,6 +595,7 @@ namespace Sass {
     Binary_Expression* b2 = dynamic_cast<Binary_Expression*>(b->right());
 
     bool schema_op = false;
+    bool interpolated = false;
 
     bool force_delay = (s2 && s2->is_left_interpolant()) ||
                        (s1 && s1->is_right_interpolant()) ||
@@ -591,6 +604,8 @@ namespace Sass {
 
     if ((s1 && s1->has_interpolants()) || (s2 && s2->has_interpolants()) || force_delay)
     {
+      // operands may get replaced
+      interpolated = true;
       // If possible upgrade LHS to a number
       if (op_type == Sass_OP::DIV || op_type == Sass_OP::MUL || op_type == Sass_OP::MOD || op_type == Sass_OP::ADD || op_type == Sass_OP::SUB ||
           op_type == Sass_OP::EQ) {
@@ -643,15 +658,24 @@ namespace Sass {
 
     // see if it's a relational expression
     try {
+      Boolean* rel = 0;
       switch(op_type) {
-        case Sass_OP::EQ:  return SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), eq(lhs, rhs));
-        case Sass_OP::NEQ: return SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), !eq(lhs, rhs));
-        case Sass_OP::GT:  return SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), !lt(lhs, rhs, "gt") && !eq(lhs, rhs));
-        case Sass_OP::GTE: return SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), !lt(lhs, rhs, "gte"));
-        case Sass_OP::LT:  return SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), lt(lhs, rhs, "lt"));
-        case Sass_OP::LTE: return SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), lt(lhs, rhs, "lte") || eq(lhs, rhs));
+        case Sass_OP::EQ:  rel = SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), eq(lhs, rhs)); break;
+        case Sass_OP::NEQ: rel = SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), !eq(lhs, rhs)); break;
+        case Sass_OP::GT:  rel = SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), !lt(lhs, rhs, "gt") && !eq(lhs, rhs)); break;
+        case Sass_OP::GTE: rel = SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), !lt(lhs, rhs, "gte")); break;
+        case Sass_OP::LT:  rel = SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), lt(lhs, rhs, "lt")); break;
+        case Sass_OP::LTE: rel = SASS_MEMORY_NEW(ctx.mem, Boolean, b->pstate(), lt(lhs, rhs, "lte") || eq(lhs, rhs)); break;
         default:                     break;
       }
+      if (rel) {
+        // operands are dead now
+        if (!interpolated) {
+          reclaim(b->left(), lhs);
+          reclaim(b->right(), rhs);
+        }
+        return rel;
+      }
     }
     catch (Exception::OperationError& err)
     {
@@ -671,6 +695,11 @@ namespace Sass {
         const Number* l_n = dynamic_cast<const Number*>(lhs);
         const Number* r_n = dynamic_cast<const Number*>(rhs);
         rv = op_numbers(ctx.mem, op_type, *l_n, *r_n, ctx.c_options, &pstate);
+        // operands are dead now
+        if (!interpolated) {
+          reclaim(b->left(), lhs);
+          reclaim(b->right(), rhs);
+        }
       }
       else if (l_type == Expression::NUMBER && r_type == Expression::COLOR) {
         const Number* l_n = dynamic_cast<const Number*>(lhs);
@@ -730,6 +759,34 @@ namespace Sass {
 
   }
 
+  // Check if `val` is a number we just created while evaluating `ex`.
+  // These are only referenced by the caller and can be released once
+  // the caller has consumed them (i.e. operands of arithmetic ops).
+  bool Eval::is_temporary(Expression* ex, Expression* val)
+  {
+    if (val->concrete_type() != Expression::NUMBER) return false;
+    // unary ops always return a new number
+    if (dynamic_cast<Unary_Expression*>(ex)) return true;
+    // arithmetic ops return a new number from op_numbers
+    if (Binary_Expression* b = dynamic_cast<Binary_Expression*>(ex)) {
+      switch (b->type()) {
+        case Sass_OP::ADD: case Sass_OP::SUB:
+        case Sass_OP::MUL: case Sass_OP::DIV:
+        case Sass_OP::MOD: return true;
+        default: return false;
+      }
+    }
+    return false;
+  }
+
+  // release a temporary value once it is dead
+  void Eval::reclaim(Expression* ex, Expression* val)
+  {
+    if (is_temporary(ex, val) && ctx.mem.has(val)) {
+      ctx.mem.destroy(val);
+    }
+  }
+
   Expression* Eval::operator()(Unary_Expression* u)
   {
     Expression* operand = u->operand()->perform(this);
@@ -743,18 +800,22 @@ namespace Sass {
       result->value(u->type() == Unary_Expression::MINUS
                     ? -result->value()
                     :  result->value());
+      // operand is dead now
+      reclaim(u->operand(), operand);
       return result;
     }
     else {
       // Special cases: +/- variables which evaluate to null ouput just +/-,
       // but +/- null itself outputs the string
+      // inspect a copy, the parsed tree may be shared
+      Unary_Expression* ex = SASS_MEMORY_NEW(ctx.mem, Unary_Expression, *u);
       if (operand->concrete_type() == Expression::NULL_VAL && dynamic_cast<Variable*>(u->operand())) {
-        u->operand(SASS_MEMORY_NEW(ctx.mem, String_Quoted, u->pstate(), ""));
+        ex->operand(SASS_MEMORY_NEW(ctx.mem, String_Quoted, u->pstate(), ""));
       }
-      else u->operand(operand);
+      else ex->operand(operand);
       String_Constant* result = SASS_MEMORY_NEW(ctx.mem, String_Quoted,
                                                   u->pstate(),
-                                                  u->inspect());
+                                                  ex->inspect());
       return result;
     }
     // unreachable
@@ -769,47 +830,58 @@ namespace Sass {
         stm << "Stack depth exceeded max of " << Constants::MaxCallStack;
         error(stm.str(), c->pstate(), backtrace());
     }
-    std::string name(Util::normalize_underscores(c->name()));
-    std::string full_name(name + "[f]");
+    Symbol full_name(c->symbol());
     Arguments* args = SASS_MEMORY_NEW(ctx.mem, Arguments, *c->arguments());
 
     Env* env = environment();
-    if (!env->has(full_name)) {
-      if (!env->has("*[f]")) {
-        args = static_cast<Arguments*>(args->perform(this));
-        Function_Call* lit = SASS_MEMORY_NEW(ctx.mem, Function_Call,
-                                             c->pstate(),
-                                             c->name(),
-                                             args);
-        if (args->has_named_arguments()) {
-          error("Function " + c->name() + " doesn't support keyword arguments", c->pstate());
-        }
-        String_Quoted* str = SASS_MEMORY_NEW(ctx.mem, String_Quoted,
-                                             c->pstate(),
-                                             lit->to_string(ctx.c_options));
-        str->is_interpolant(c->is_interpolant());
-        return str;
-      } else {
-        // call generic function
-        full_name = "*[f]";
+    Definition* def = 0;
+    // reuse the lookup from the last call at this site
+    if (c->cached_scope() == env->definitions() &&
+        c->cached_stamp() == Env::definitions_stamp()) {
+      full_name = c->cached_symbol();
+      def = c->cached_definition();
+    }
+    else {
+      if (!full_name || !env->has(full_name)) {
+        if (env->has(Symbols::generic_fn)) full_name = Symbols::generic_fn;
+        else full_name = 0;
       }
+      if (full_name) def = static_cast<Definition*>((*env)[full_name]);
+      c->cached_scope(env->definitions());
+      c->cached_stamp(Env::definitions_stamp());
+      c->cached_symbol(full_name);
+      c->cached_definition(def);
+    }
+
+    // not a sass function, output as plain css
+    if (!def) {
+      args = static_cast<Arguments*>(args->perform(this));
+      Function_Call* lit = SASS_MEMORY_NEW(ctx.mem, Function_Call,
+                                           c->pstate(),
+                                           c->name(),
+                                           args);
+      if (args->has_named_arguments()) {
+        error("Function " + c->name() + " doesn't support keyword arguments", c->pstate());
+      }
+      String_Quoted* str = SASS_MEMORY_NEW(ctx.mem, String_Quoted,
+                                           c->pstate(),
+                                           lit->to_string(ctx.c_options));
+      str->is_interpolant(c->is_interpolant());
+      return str;
     }
 
     // further delay for calls
-    if (full_name != "call[f]") {
+    if (full_name != Symbols::call_fn) {
       args->set_delayed(false); // verified
     }
-    if (full_name != "if[f]") {
+    if (full_name != Symbols::if_fn) {
       args = static_cast<Arguments*>(args->perform(this));
     }
-    Definition* def = static_cast<Definition*>((*env)[full_name]);
-
     if (def->is_overload_stub()) {
       std::stringstream ss;
-      ss << full_name
+      ss << Symbol_Table::name(full_name)
          << args->length();
-      full_name = ss.str();
-      std::string resolved_name(full_name);
+      std::string resolved_name(ss.str());
       if (!env->has(resolved_name)) error("overloaded function `" + std::string(c->name()) + "` given wrong number of arguments", c->pstate());
       def = static_cast<Definition*>((*env)[resolved_name]);
     }
@@ -828,7 +900,7 @@ namespace Sass {
       Backtrace here(backtrace(), c->pstate(), ", in function `" + c->name() + "`");
       exp.backtrace_stack.push_back(&here);
       // eval the body if user-defined or special, invoke underlying CPP function if native
-      if (body && !Prelexer::re_special_fun(name.c_str())) { result = body->perform(this); }
+      if (body && !Prelexer::re_special_fun(Util::normalize_underscores(c->name()).c_str())) { result = body->perform(this); }
       else if (func) { result = func(fn_env, *env, ctx, def->signature(), c->pstate(), backtrace(), exp.selector_stack); }
       if (!result) error(std::string("Function ") + c->name() + " did not return a value", c->pstate());
       exp.backtrace_stack.pop_back();
@@ -838,7 +910,7 @@ namespace Sass {
     // convert call into C-API compatible form
     else if (c_function) {
       Sass_Function_Fn c_func = sass_function_get_function(c_function);
-      if (full_name == "*[f]") {
+      if (full_name == Symbols::generic_fn) {
         String_Quoted *str = SASS_MEMORY_NEW(ctx.mem, String_Quoted, c->pstate(), c->name());
         Arguments* new_args = SASS_MEMORY_NEW(ctx.mem, Arguments, c->pstate());
         *new_args << SASS_MEMORY_NEW(ctx.mem, Argument, c->pstate(), str);
@@ -856,8 +928,7 @@ namespace Sass {
       To_C to_c;
       union Sass_Value* c_args = sass_make_list(params[0].length(), SASS_COMMA);
       for(size_t i = 0; i < params[0].length(); i++) {
-        std::string key = params[0][i]->name();
-        AST_Node* node = fn_env.get_local(key);
+        AST_Node* node = fn_env.get_local(params[0][i]->symbol());
         Expression* arg = static_cast<Expression*>(node);
         sass_list_set_value(c_args, i, arg->perform(&to_c));
       }
@@ -877,11 +948,17 @@ namespace Sass {
 
     // link back to function definition
     // only do this for custom functions
-    if (result->pstate().file == std::string::npos)
+    if (result->pstate().file == std::string::npos) {
+      result = copy_value(result);
       result->pstate(c->pstate());
+    }
 
     result = result->perform(this);
-    result->is_interpolant(c->is_interpolant());
+    // result may be a shared value
+    if (result->is_interpolant() != c->is_interpolant()) {
+      result = copy_value(result);
+      result->is_interpolant(c->is_interpolant());
+    }
     exp.env_stack.pop_back();
     return result;
   }
@@ -897,13 +974,21 @@ namespace Sass {
 
   Expression* Eval::operator()(Variable* v)
   {
-    std::string name(v->name());
+    Symbol name(v->symbol());
     Expression* value = 0;
     Env* env = environment();
-    if (env->has(name)) value = static_cast<Expression*>((*env)[name]);
+    // use the frame found by the resolver
+    AST_Node** bound = 0;
+    if (v->depth() >= 0) bound = env->find_local(name, v->depth());
+    if (bound) value = static_cast<Expression*>(*bound);
+    else if (env->has(name)) value = static_cast<Expression*>((*env)[name]);
     else error("Undefined variable: \"" + v->name() + "\".", v->pstate());
     if (typeid(*value) == typeid(Argument)) value = static_cast<Argument*>(value)->value();
 
+    // values are shared (copy on write), so we can return
+    // the stored value if it already has the requested flags
+    if (is_shareable(value, v->is_interpolant())) return value;
+
     // behave according to as ruby sass (add leading zero)
     if (value->concrete_type() == Expression::NUMBER) {
       value = SASS_MEMORY_NEW(ctx.mem, Number, *static_cast<Number*>(value));
@@ -941,6 +1026,67 @@ namespace Sass {
     return value->perform(this);
   }
 
+  // Check if a stored value can be returned as is for a variable
+  // read. This is the case if the copy we would otherwise create
+  // has exactly the same flags (and evaluates to itself).
+  bool Eval::is_shareable(Expression* value, bool is_interpolant)
+  {
+    if (value->is_delayed()) return false;
+    if (value->is_interpolant() != is_interpolant) return false;
+    switch (value->concrete_type()) {
+      case Expression::NUMBER:
+        return static_cast<Number*>(value)->zero();
+      case Expression::BOOLEAN:
+      case Expression::COLOR:
+      case Expression::NULL_VAL:
+        return true;
+      case Expression::LIST:
+        if (List* l = dynamic_cast<List*>(value)) {
+          return l->is_expanded() && !l->is_arglist();
+        }
+        return false;
+      case Expression::MAP:
+        return value->is_expanded();
+      default:
+        return false;
+    }
+  }
+
+  // Create a copy of a value before we change any of its
+  // flags, since values may be shared between variables.
+  Expression* Eval::copy_value(Expression* value)
+  {
+    switch (value->concrete_type()) {
+      case Expression::NUMBER:
+        return SASS_MEMORY_NEW(ctx.mem, Number, *static_cast<Number*>(value));
+      case Expression::BOOLEAN:
+        return SASS_MEMORY_NEW(ctx.mem, Boolean, *static_cast<Boolean*>(value));
+      case Expression::COLOR:
+        return SASS_MEMORY_NEW(ctx.mem, Color, *static_cast<Color*>(value));
+      case Expression::NULL_VAL:
+        return SASS_MEMORY_NEW(ctx.mem, Null, *static_cast<Null*>(value));
+      case Expression::LIST:
+        if (typeid(*value) == typeid(List)) {
+          return SASS_MEMORY_NEW(ctx.mem, List, *static_cast<List*>(value));
+        }
+        break;
+      case Expression::MAP:
+        return SASS_MEMORY_NEW(ctx.mem, Map, *static_cast<Map*>(value));
+      case Expression::STRING:
+        if (typeid(*value) == typeid(String_Quoted)) {
+          return SASS_MEMORY_NEW(ctx.mem, String_Quoted, *static_cast<String_Quoted*>(value));
+        }
+        else if (typeid(*value) == typeid(String_Constant)) {
+          return SASS_MEMORY_NEW(ctx.mem, String_Constant, *static_cast<String_Constant*>(value));
+        }
+        break;
+      default:
+        break;
+    }
+    // not a plain value
+    return value;
+  }
+
   Expression* Eval::operator()(Textual* t)
   {
     using Prelexer::number;
@@ -1073,8 +1219,11 @@ namespace Sass {
       // this fixes an issue with bourbon sample, not really sure why
       // if (l->size() && dynamic_cast<Null*>((*l)[0])) { res += ""; }
       for(auto item : *l) {
+        // items may be shared, so restore the flag afterwards
+        bool was_interpolant = item->is_interpolant();
         item->is_interpolant(l->is_interpolant());
         std::string rl(""); interpolation(ctx, rl, item, into_quotes, l->is_interpolant());
+        item->is_interpolant(was_interpolant);
         bool is_null = dynamic_cast<Null*>(item) != 0; // rl != ""
         if (!is_null) *ll << SASS_MEMORY_NEW(ctx.mem, String_Quoted, item->pstate(), rl);
       }
@@ -1401,11 +1550,9 @@ namespace Sass {
     Number tmp(r);
     bool strict = op != Sass_OP::MUL && op != Sass_OP::DIV;
     tmp.normalize(l.find_convertible_unit(), strict);
-    std::string l_unit(l.unit());
-    std::string r_unit(tmp.unit());
     Number* v = SASS_MEMORY_NEW(mem, Number, l);
     v->pstate(pstate ? *pstate : l.pstate());
-    if (l_unit.empty() && (op == Sass_OP::ADD || op == Sass_OP::SUB || op == Sass_OP::MOD)) {
+    if (l.is_unitless() && (op == Sass_OP::ADD || op == Sass_OP::SUB || op == Sass_OP::MOD)) {
       v->numerator_units() = r.numerator_units();
       v->denominator_units() = r.denominator_units();
     }
@@ -1644,9 +1791,36 @@ namespace Sass {
   }
 
 
+  // copy the compound selectors and all wrapped selectors
+  static Sequence_Selector* copy_selector(Context& ctx, Sequence_Selector* s)
+  {
+    Sequence_Selector* cpy = s->cloneFully(ctx);
+    for (Sequence_Selector* cur = cpy; cur; cur = cur->tail()) {
+      SimpleSequence_Selector* head = cur->head();
+      if (head == 0) continue;
+      for (size_t i = 0, L = head->length(); i < L; ++i) {
+        if (Wrapped_Selector* ws = dynamic_cast<Wrapped_Selector*>((*head)[i])) {
+          ws = SASS_MEMORY_NEW(ctx.mem, Wrapped_Selector, *ws);
+          if (CommaSequence_Selector* sl = dynamic_cast<CommaSequence_Selector*>(ws->selector())) {
+            sl = SASS_MEMORY_NEW(ctx.mem, CommaSequence_Selector, *sl);
+            for (size_t n = 0, N = sl->length(); n < N; ++n) {
+              (*sl)[n] = copy_selector(ctx, (*sl)[n]);
+            }
+            ws->selector(sl);
+          }
+          (*head)[i] = ws;
+        }
+      }
+    }
+    return cpy;
+  }
+
   CommaSequence_Selector* Eval::operator()(Sequence_Selector* s)
   {
     bool implicit_parent = !exp.old_at_root_without_rule;
+    // parsed trees may be shared with other compilations (see Parse_Cache)
+    // selectors are altered in place by later stages, so we use a copy
+    if (ctx.parse_cache) s = copy_selector(ctx, s);
     return s->resolve_parent_refs(ctx, selector(), implicit_parent);
 
   }
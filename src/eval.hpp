@@ -98,6 +98,12 @@ namespace Sass {
     static Value* op_strings(Memory_Manager&, Sass::Operand, Value&, Value&, struct Sass_Inspect_Options opt, ParserState* pstate = 0, bool interpolant = false);
 
   private:
+    // support for copy on write values
+    bool is_shareable(Expression* value, bool is_interpolant);
+    Expression* copy_value(Expression* value);
+    // release dead temporaries early
+    bool is_temporary(Expression* ex, Expression* val);
+    void reclaim(Expression* ex, Expression* val);
     void interpolation(Context& ctx, std::string& res, Expression* ex, bool into_quotes, bool was_itpl = false);
 
   };
@@ -250,7 +250,7 @@ namespace Sass {
   Statement* Expand::operator()(Assignment* a)
   {
     Env* env = environment();
-    std::string var(a->variable());
+    Symbol var(a->symbol());
     if (a->is_global()) {
       if (a->is_default()) {
         if (env->has_global(var)) {
@@ -395,7 +395,7 @@ namespace Sass {
   // But iteration vars are reset afterwards
   Statement* Expand::operator()(For* f)
   {
-    std::string variable(f->variable());
+    Symbol variable(Symbol_Table::intern(f->variable()));
     Expression* low = f->lower_bound()->perform(&eval);
     if (low->concrete_type() != Expression::NUMBER) {
       throw Exception::TypeMismatch(*low, "integer");
@@ -415,19 +415,18 @@ namespace Sass {
     }
     double start = sass_start->value();
     double end = sass_end->value();
-    // only create iterator once in this environment
     Env env(environment(), true);
     env_stack.push_back(&env);
     call_stack.push_back(f);
-    Number* it = SASS_MEMORY_NEW(env.mem, Number, low->pstate(), start, sass_end->unit());
-    env.set_local(variable, it);
     Block* body = f->block();
+    // create a new iterator for each step, since
+    // the value may be shared by other variables
     if (start < end) {
       if (f->is_inclusive()) ++end;
       for (double i = start;
            i < end;
            ++i) {
-        it->value(i);
+        Number* it = SASS_MEMORY_NEW(ctx.mem, Number, low->pstate(), i, sass_end->unit());
         env.set_local(variable, it);
         append_block(body);
       }
@@ -436,7 +435,7 @@ namespace Sass {
       for (double i = start;
            i > end;
            --i) {
-        it->value(i);
+        Number* it = SASS_MEMORY_NEW(ctx.mem, Number, low->pstate(), i, sass_end->unit());
         env.set_local(variable, it);
         append_block(body);
       }
@@ -450,7 +449,10 @@ namespace Sass {
   // But iteration vars are reset afterwards
   Statement* Expand::operator()(Each* e)
   {
-    std::vector<std::string> variables(e->variables());
+    std::vector<std::string> names(e->variables());
+    std::vector<Symbol> variables(names.size());
+    for (size_t i = 0, L = names.size(); i < L; ++i)
+    { variables[i] = Symbol_Table::intern(names[i]); }
     Expression* expr = e->list()->perform(&eval);
     Vectorized<Expression*>* list = 0;
     Map* map = 0;
@@ -629,8 +631,8 @@ namespace Sass {
   {
     Env* env = environment();
     Definition* dd = SASS_MEMORY_NEW(ctx.mem, Definition, *d);
-    env->local_frame()[d->name() +
-                        (d->type() == Definition::MIXIN ? "[m]" : "[f]")] = dd;
+    env->set_definition(d->name() +
+                        (d->type() == Definition::MIXIN ? "[m]" : "[f]"), dd);
 
     if (d->type() == Definition::FUNCTION && (
       Prelexer::calc_fn_call(d->name().c_str()) ||
@@ -654,7 +656,7 @@ namespace Sass {
   Statement* Expand::operator()(Mixin_Call* c)
   {
     Env* env = environment();
-    std::string full_name(c->name() + "[m]");
+    Symbol full_name(c->symbol());
     if (!env->has(full_name)) {
       error("no mixin named " + c->name(), c->pstate(), backtrace());
     }
@@ -680,7 +682,7 @@ namespace Sass {
                                           c->block(),
                                           Definition::MIXIN);
       thunk->environment(env);
-      new_env.local_frame()["@content[m]"] = thunk;
+      new_env.set_local(Symbols::content_mixin, thunk);
     }
 
     bind(std::string("Mixin"), c->name(), params, args, &ctx, &new_env, &eval);
@@ -706,7 +708,7 @@ namespace Sass {
   {
     Env* env = environment();
     // convert @content directives into mixin calls to the underlying thunk
-    if (!env->has("@content[m]")) return 0;
+    if (!env->has(Symbols::content_mixin)) return 0;
 
     if (block_stack.back()->is_root()) {
       selector_stack.push_back(0);
@@ -8,6 +8,8 @@
 # define S_ISDIR(mode) (((mode) & S_IFMT) == S_IFDIR)
 #else
 # include <unistd.h>
+# include <fcntl.h>
+# include <sys/mman.h>
 #endif
 #include "sass.hpp"
 #include <iostream>
@@ -79,6 +81,32 @@ namespace Sass {
       #endif
     }
 
+    // get the stamp of the file at path
+    // returns false if it is not a file
+    bool get_stamp(const std::string& path, Stamp& stamp)
+    {
+      #ifdef _WIN32
+        std::wstring wpath = UTF_8::convert_to_utf16(path);
+        struct _stat64 st_buf;
+        if (_wstat64(wpath.c_str(), &st_buf) != 0) return false;
+        if (st_buf.st_mode & _S_IFDIR) return false;
+      #else
+        struct stat st_buf;
+        if (stat(path.c_str(), &st_buf) != 0) return false;
+        if (S_ISDIR(st_buf.st_mode)) return false;
+      #endif
+      // use the best resolution we can get
+      #if defined(__APPLE__)
+        stamp.mtime = st_buf.st_mtimespec.tv_sec * 1000000000LL + st_buf.st_mtimespec.tv_nsec;
+      #elif defined(__linux__)
+        stamp.mtime = st_buf.st_mtim.tv_sec * 1000000000LL + st_buf.st_mtim.tv_nsec;
+      #else
+        stamp.mtime = static_cast<long long>(st_buf.st_mtime);
+      #endif
+      stamp.size = static_cast<long long>(st_buf.st_size);
+      return true;
+    }
+
     // return if given path is absolute
     // works with *nix and windows paths
     bool is_absolute_path(const std::string& path)
@@ -363,6 +391,18 @@ namespace Sass {
       return find_file(file, includes);
     }
 
+    // files with the .sass extension need conversion
+    static bool is_indented_syntax(const std::string& path)
+    {
+      std::string extension;
+      if (path.length() > 5) {
+        extension = path.substr(path.length() - 5, 5);
+      }
+      for(size_t i=0; i<extension.size();++i)
+        extension[i] = tolower(extension[i]);
+      return extension == ".sass";
+    }
+
     // try to load the given filename
     // returned memory must be freed
     // will auto convert .sass files
@@ -399,13 +439,7 @@ namespace Sass {
           file.close();
         }
       #endif
-      std::string extension;
-      if (path.length() > 5) {
-        extension = path.substr(path.length() - 5, 5);
-      }
-      for(size_t i=0; i<extension.size();++i)
-        extension[i] = tolower(extension[i]);
-      if (extension == ".sass" && contents != 0) {
+      if (is_indented_syntax(path) && contents != 0) {
         char * converted = sass2scss(contents, SASS2SCSS_PRETTIFY_1 | SASS2SCSS_KEEP_COMMENT);
         free(contents); // free the indented contents
         return converted; // should be freed by caller
@@ -414,5 +448,63 @@ namespace Sass {
       }
     }
 
+    #ifndef _WIN32
+    // smaller files are cheaper to read
+    static const size_t MAP_FILE_MIN_SIZE = 256 * 1024;
+
+    // map a file privately into memory, followed by at least one null
+    // char: the rest of the last page of a file reads as zeros and we
+    // reserve one more zero page for files that fill their last page
+    // returns 0 if the file is too small or cannot be mapped
+    static char* map_file(const std::string& path, size_t& size)
+    {
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd == -1) return 0;
+      struct stat st;
+      if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || size_t(st.st_size) < MAP_FILE_MIN_SIZE) {
+        close(fd);
+        return 0;
+      }
+      size_t page = sysconf(_SC_PAGESIZE);
+      size = (st.st_size / page + 1) * page;
+      void* mem = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (mem != MAP_FAILED && mmap(mem, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(mem, size);
+        mem = MAP_FAILED;
+      }
+      close(fd);
+      return mem == MAP_FAILED ? 0 : (char*) mem;
+    }
+    #endif
+
+    // try to load the given filename like read_file
+    // large files are mapped into memory instead (posix)
+    // contents are 0 if the file could not be loaded
+    Resource read_resource(const std::string& path)
+    {
+      #ifndef _WIN32
+        size_t size = 0;
+        // indented syntax is converted into a new buffer anyway
+        if (!is_indented_syntax(path)) {
+          if (char* contents = map_file(path, size)) return Resource(contents, 0, size);
+        }
+      #endif
+      return Resource(read_file(path), 0);
+    }
+
+    // release the memory of a loaded resource
+    void free_resource(Resource& res)
+    {
+      #ifndef _WIN32
+        if (res.mapped) munmap(res.contents, res.mapped);
+        else free(res.contents);
+      #else
+        free(res.contents);
+      #endif
+      free(res.srcmap);
+      res.contents = 0;
+      res.srcmap = 0;
+    }
+
   }
 }
@@ -18,6 +18,19 @@ namespace Sass {
     // test if path exists and is a file
     bool file_exists(const std::string& file);
 
+    // modification time and size of a file
+    // used to detect changes between compiles
+    struct Stamp {
+      long long mtime;
+      long long size;
+      bool operator==(const Stamp& rhs) const
+      { return mtime == rhs.mtime && size == rhs.size; }
+    };
+
+    // get the stamp of the file at path
+    // returns false if it is not a file
+    bool get_stamp(const std::string& path, Stamp& stamp);
+
     // return if given path is absolute
     // works with *nix and windows paths
     bool is_absolute_path(const std::string& path);
@@ -95,12 +108,27 @@ namespace Sass {
       char* contents;
       // conected sourcemap
       char* srcmap;
+      // size of the mapping if the contents
+      // are a file mapped into memory (or 0)
+      size_t mapped;
     public:
-      Resource(char* contents, char* srcmap)
-      : contents(contents), srcmap(srcmap)
+      Resource(char* contents, char* srcmap, size_t mapped = 0)
+      : contents(contents), srcmap(srcmap), mapped(mapped)
       { }
   };
 
+  namespace File {
+
+    // try to load the given filename like read_file
+    // large files are mapped into memory instead (posix)
+    // contents are 0 if the file could not be loaded
+    Resource read_resource(const std::string& path);
+
+    // release the memory of a loaded resource
+    void free_resource(Resource& res);
+
+  }
+
   // parsed stylesheet from loaded resource
   class StyleSheet : public Resource {
     public:
@@ -149,6 +149,18 @@ namespace Sass {
       return val;
     }
 
+    // copy since the value may be shared
+    String_Constant* unquoted_copy(String_Constant* str, Context& ctx)
+    {
+      if (String_Quoted* qstr = dynamic_cast<String_Quoted*>(str)) {
+        str = SASS_MEMORY_NEW(ctx.mem, String_Quoted, *qstr);
+      } else {
+        str = SASS_MEMORY_NEW(ctx.mem, String_Constant, *str);
+      }
+      str->quote_mark(0);
+      return str;
+    }
+
     #define ARGSEL(argname, seltype, contextualize) get_arg_sel<seltype>(argname, env, sig, pstate, backtrace, ctx)
 
     template <typename T>
@@ -164,7 +176,7 @@ namespace Sass {
         error(msg.str(), pstate);
       }
       if (String_Constant* str =dynamic_cast<String_Constant*>(exp)) {
-        str->quote_mark(0);
+        exp = unquoted_copy(str, ctx);
       }
       std::string exp_src = exp->to_string(ctx.c_options) + "{";
       return Parser::parse_selector(exp_src.c_str(), ctx);
@@ -180,7 +192,7 @@ namespace Sass {
         error(msg.str(), pstate);
       }
       if (String_Constant* str =dynamic_cast<String_Constant*>(exp)) {
-        str->quote_mark(0);
+        exp = unquoted_copy(str, ctx);
       }
       std::string exp_src = exp->to_string(ctx.c_options) + "{";
       CommaSequence_Selector* sel_list = Parser::parse_selector(exp_src.c_str(), ctx);
@@ -196,7 +208,7 @@ namespace Sass {
         error(msg.str(), pstate);
       }
       if (String_Constant* str =dynamic_cast<String_Constant*>(exp)) {
-        str->quote_mark(0);
+        exp = unquoted_copy(str, ctx);
       }
       std::string exp_src = exp->to_string(ctx.c_options) + "{";
       CommaSequence_Selector* sel_list = Parser::parse_selector(exp_src.c_str(), ctx);
@@ -904,6 +916,8 @@ namespace Sass {
       AST_Node* arg = env["$string"];
       // only set quote mark to true if already a string
       if (String_Quoted* qstr = dynamic_cast<String_Quoted*>(arg)) {
+        // copy since the value may be shared
+        qstr = SASS_MEMORY_NEW(ctx.mem, String_Quoted, *qstr);
         qstr->quote_mark('*');
         return qstr;
       }
@@ -1293,6 +1307,8 @@ namespace Sass {
       for (size_t i = 0, L = l->length(); i < L; ++i) {
         *result << ((i == index) ? v : (*l)[i]);
       }
+      // both arguments have been evaluated already
+      result->is_expanded(true);
       return result;
     }
 
@@ -1335,6 +1351,8 @@ namespace Sass {
       List* result = SASS_MEMORY_NEW(ctx.mem, List, pstate, len, sep_val);
       *result += l1;
       *result += l2;
+      // both lists have been evaluated already
+      result->is_expanded(true);
       return result;
     }
 
@@ -1371,6 +1389,8 @@ namespace Sass {
       } else {
         *result << v;
       }
+      // both arguments have been evaluated already
+      result->is_expanded(true);
       return result;
     }
 
@@ -1426,12 +1446,8 @@ namespace Sass {
     {
       Map* m = ARGM("$map", Map, ctx);
       Expression* v = ARG("$key", Expression);
-      try {
-        return m->at(v);
-      } catch (const std::out_of_range&) {
-        return SASS_MEMORY_NEW(ctx.mem, Null, pstate);
-      }
-      catch (...) { throw; }
+      if (Expression* value = m->find(v)) return value;
+      return SASS_MEMORY_NEW(ctx.mem, Null, pstate);
     }
 
     Signature map_has_key_sig = "map-has-key($map, $key)";
@@ -1439,7 +1455,7 @@ namespace Sass {
     {
       Map* m = ARGM("$map", Map, ctx);
       Expression* v = ARG("$key", Expression);
-      return SASS_MEMORY_NEW(ctx.mem, Boolean, pstate, m->has(v));
+      return SASS_MEMORY_NEW(ctx.mem, Boolean, pstate, m->find(v) != 0);
     }
 
     Signature map_keys_sig = "map-keys($map)";
@@ -1470,36 +1486,54 @@ namespace Sass {
       Map* m1 = ARGM("$map1", Map, ctx);
       Map* m2 = ARGM("$map2", Map, ctx);
 
-      size_t len = m1->length() + m2->length();
-      Map* result = SASS_MEMORY_NEW(ctx.mem, Map, pstate, len);
+      // entries of m1 are shared, no need to reserve space
+      Map* result = SASS_MEMORY_NEW(ctx.mem, Map, pstate);
       *result += m1;
       *result += m2;
+      // both maps have been evaluated already
+      result->is_expanded(true);
       return result;
     }
 
     Signature map_remove_sig = "map-remove($map, $keys...)";
     BUILT_IN(map_remove)
     {
-      bool remove;
       Map* m = ARGM("$map", Map, ctx);
       List* arglist = ARG("$keys", List);
-      Map* result = SASS_MEMORY_NEW(ctx.mem, Map, pstate, 1);
+      // match keys as before with Eval::eq, the hash index
+      // would not find a key like 2px when removing 2
+      std::vector<bool> remove(m->length(), false);
+      size_t removed = 0, i = 0;
       for (auto key : m->keys()) {
-        remove = false;
-        for (size_t j = 0, K = arglist->length(); j < K && !remove; ++j) {
-          remove = Eval::eq(key, arglist->value_at_index(j));
+        for (size_t j = 0, K = arglist->length(); j < K && !remove[i]; ++j) {
+          remove[i] = Eval::eq(key, arglist->value_at_index(j));
         }
-        if (!remove) *result << std::make_pair(key, m->at(key));
+        if (remove[i ++]) ++ removed;
+      }
+      // nothing to remove, share the entries
+      if (!removed) {
+        Map* result = SASS_MEMORY_NEW(ctx.mem, Map, pstate);
+        *result += m;
+        result->is_expanded(true);
+        return result;
       }
+      Map* result = SASS_MEMORY_NEW(ctx.mem, Map, pstate, m->length() - removed);
+      i = 0;
+      for (auto key : m->keys()) {
+        if (!remove[i ++]) *result << std::make_pair(key, m->at(key));
+      }
+      // the map has been evaluated already
+      result->is_expanded(true);
       return result;
     }
 
     Signature keywords_sig = "keywords($args)";
     BUILT_IN(keywords)
     {
-      List* arglist = SASS_MEMORY_NEW(ctx.mem, List, *ARG("$args", List));
-      Map* result = SASS_MEMORY_NEW(ctx.mem, Map, pstate, 1);
-      for (size_t i = arglist->size(), L = arglist->length(); i < L; ++i) {
+      List* arglist = ARG("$args", List);
+      size_t first = arglist->size(), L = arglist->length();
+      Map* result = SASS_MEMORY_NEW(ctx.mem, Map, pstate, L - first);
+      for (size_t i = first; i < L; ++i) {
         std::string name = std::string(((Argument*)(*arglist)[i])->name());
         name = name.erase(0, 1); // sanitize name (remove dollar sign)
         *result << std::make_pair(SASS_MEMORY_NEW(ctx.mem, String_Quoted,
@@ -1538,7 +1572,7 @@ namespace Sass {
       }
       Number tmp_n2(*n2);
       tmp_n2.normalize(n1->find_convertible_unit());
-      return SASS_MEMORY_NEW(ctx.mem, Boolean, pstate, n1->unit() == tmp_n2.unit());
+      return SASS_MEMORY_NEW(ctx.mem, Boolean, pstate, n1->has_same_units(tmp_n2));
     }
 
     Signature variable_exists_sig = "variable-exists($name)";
@@ -1636,7 +1670,9 @@ namespace Sass {
           *args << SASS_MEMORY_NEW(ctx.mem, Argument, pstate, expr);
         }
       }
-      Function_Call* func = SASS_MEMORY_NEW(ctx.mem, Function_Call, pstate, name, args);
+      // do not intern names that only show up at runtime
+      Symbol symbol = Symbol_Table::find(Util::normalize_underscores(name) + "[f]");
+      Function_Call* func = SASS_MEMORY_NEW(ctx.mem, Function_Call, pstate, name, symbol, args);
       Expand expand(ctx, &d_env, backtrace, &selector_stack);
       return func->perform(&expand.eval);
 
@@ -1725,7 +1761,7 @@ namespace Sass {
           error(msg.str(), pstate);
         }
         if (String_Constant* str =dynamic_cast<String_Constant*>(exp)) {
-          str->quote_mark(0);
+          exp = unquoted_copy(str, ctx);
         }
         std::string exp_src = exp->to_string(ctx.c_options) + "{";
         CommaSequence_Selector* sel = Parser::parse_selector(exp_src.c_str(), ctx);
@@ -1776,7 +1812,7 @@ namespace Sass {
           error(msg.str(), pstate);
         }
         if (String_Constant* str =dynamic_cast<String_Constant*>(exp)) {
-          str->quote_mark(0);
+          exp = unquoted_copy(str, ctx);
         }
         std::string exp_src = exp->to_string() + "{";
         CommaSequence_Selector* sel = Parser::parse_selector(exp_src.c_str(), ctx);
@@ -1139,27 +1139,59 @@ static void emit_object_indented(SB *out, const JsonNode *object, const char *sp
   sb_putc(out, '}');
 }
 
-void emit_string(SB *out, const char *str)
+/*
+ * Number of bytes needed to encode a (valid or invalid)
+ * UTF-8 string, including the quotation marks.
+ */
+static size_t string_length(const char *str, bool escape_unicode)
 {
-  bool escape_unicode = false;
   const char *s = str;
-  char *b;
+  size_t length = 2;
 
-// make assertion catchable
-#ifndef NDEBUG
-  if (!utf8_validate(str)) {
-    throw utf8::invalid_utf8(0);
+  while (*s != 0) {
+    unsigned char c = *s;
+
+    switch (c) {
+      case '"':
+      case '\\':
+      case '\b':
+      case '\f':
+      case '\n':
+      case '\r':
+      case '\t':
+        length += 2;
+        s++;
+        break;
+      default: {
+        int len = utf8_validate_cz(s);
+
+        if (len == 0) {
+          /* Replacement character (see write_string). */
+          length += escape_unicode ? 6 : 3;
+          s++;
+        } else if (c < 0x1F || (c >= 0x80 && escape_unicode)) {
+          uint32_t unicode;
+          s += utf8_read_char(s, &unicode);
+          length += unicode <= 0xFFFF ? 6 : 12;
+        } else {
+          length += len;
+          s += len;
+        }
+        break;
+      }
+    }
   }
-#endif
 
-  assert(utf8_validate(str));
+  return length;
+}
 
-  /*
-   * 14 bytes is enough space to write up to two
-   * \uXXXX escapes and two quotation marks.
-   */
-  sb_need(out, 14);
-  b = out->cur;
+/*
+ * Write the encoded string to b, which must have room
+ * for string_length bytes. Returns the end of the output.
+ */
+static char *write_string(char *b, const char *str, bool escape_unicode)
+{
+  const char *s = str;
 
   *b++ = '"';
   while (*s != 0) {
@@ -1208,11 +1240,11 @@ void emit_string(SB *out, const char *str)
            * and skipping a single byte.
            *
            * This should never happen when assertions are enabled
-           * due to the assertion at the beginning of this function.
+           * due to the assertion in validate_string.
            */
           assert(false);
           if (escape_unicode) {
-            strcpy(b, "\\uFFFD");
+            memcpy(b, "\\uFFFD", 6);
             b += 6;
           } else {
             *b++ = 0xEFu;
@@ -1251,18 +1283,45 @@ void emit_string(SB *out, const char *str)
         break;
       }
     }
-
-    /*
-     * Update *out to know about the new bytes,
-     * and set up b to write another encoded character.
-     */
-    out->cur = b;
-    sb_need(out, 14);
-    b = out->cur;
   }
   *b++ = '"';
 
-  out->cur = b;
+  return b;
+}
+
+static void validate_string(const char *str)
+{
+// make assertion catchable
+#ifndef NDEBUG
+  if (!utf8_validate(str)) {
+    throw utf8::invalid_utf8(0);
+  }
+#endif
+
+  assert(utf8_validate(str));
+}
+
+void emit_string(SB *out, const char *str)
+{
+  bool escape_unicode = false;
+  size_t length;
+
+  validate_string(str);
+
+  length = string_length(str, escape_unicode);
+  sb_need(out, (int)length);
+  out->cur = write_string(out->cur, str, escape_unicode);
+}
+
+size_t json_string_length(const char *str)
+{
+  validate_string(str);
+  return string_length(str, false);
+}
+
+char *json_write_string(char *out, const char *str)
+{
+  return write_string(out, str, false);
 }
 
 static void emit_number(SB *out, double num)
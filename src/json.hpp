@@ -76,6 +76,14 @@ void        json_delete         (JsonNode *node);
 
 bool        json_validate       (const char *json);
 
+/*
+ * Encode a string without allocating: json_string_length returns the
+ * size of the encoded string (including quotes, excluding terminator)
+ * and json_write_string writes it to out, returning the end pointer.
+ */
+size_t      json_string_length  (const char *str);
+char       *json_write_string   (char *out, const char *str);
+
 /*** Lookup and traversal ***/
 
 JsonNode   *json_find_element   (JsonNode *array, int index);
@@ -5,6 +5,7 @@
 #include <iomanip>
 #include "lexer.hpp"
 #include "constants.hpp"
+#include "char_scan.hpp"
 
 
 namespace Sass {
@@ -129,13 +130,13 @@ namespace Sass {
     const char* escapable_character(const char* src) { return is_escapable_character(*src) ? src + 1 : 0; }
 
     // Match multiple ctype characters.
-    const char* spaces(const char* src) { return one_plus<space>(src); }
+    const char* spaces(const char* src) { const char* p = scan_spaces(src); return p == src ? 0 : p; }
     const char* digits(const char* src) { return one_plus<digit>(src); }
     const char* hyphens(const char* src) { return one_plus<hyphen>(src); }
 
     // Whitespace handling.
     const char* no_spaces(const char* src) { return negate< space >(src); }
-    const char* optional_spaces(const char* src) { return zero_plus< space >(src); }
+    const char* optional_spaces(const char* src) { return scan_spaces(src); }
 
     // Match any single character.
     const char* any_char(const char* src) { return *src ? src + 1 : src; }
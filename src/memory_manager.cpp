@@ -1,11 +1,35 @@
 #include "sass.hpp"
+#include <new>
+#include <cstdlib>
 #include "ast.hpp"
 #include "memory_manager.hpp"
 
 namespace Sass {
 
+  // alignment for every node we hand out
+  static const size_t SASS_MEM_ALIGN = 16;
+  // first chunk is small, since we also have
+  // short lived managers (i.e. on environments)
+  static const size_t SASS_MEM_CHUNK_MIN = 4 * 1024;
+  // chunks are doubled in size until this limit
+  static const size_t SASS_MEM_CHUNK_MAX = 1024 * 1024;
+  // only recycle memory up to this size
+  static const size_t SASS_MEM_RECYCLE_MAX = 1024;
+
+  // round up to the next aligned size
+  static inline size_t align_size(size_t size)
+  {
+    return (size + SASS_MEM_ALIGN - 1) & ~(SASS_MEM_ALIGN - 1);
+  }
+
   Memory_Manager::Memory_Manager(size_t size)
-  : nodes(std::vector<Memory_Object*>())
+  : nodes(std::vector<Memory_Object*>()),
+    chunks(std::vector<Memory_Chunk>()),
+    cur(0), end(0),
+    next_chunk_size(SASS_MEM_CHUNK_MIN),
+    free_lists(),
+    bytes_allocated(0),
+    nodes_allocated(0)
   {
     size_t init = size;
     if (init < 8) init = 8;
@@ -15,37 +39,82 @@ namespace Sass {
 
   Memory_Manager::~Memory_Manager()
   {
-    // release memory for all controlled nodes
+    // call destructors for all controlled nodes
     // avoid calling erase for every single node
     for (size_t i = 0, S = nodes.size(); i < S; ++i) {
       deallocate(nodes[i]);
     }
     // just in case
     nodes.clear();
+    // release the memory in one go
+    for (size_t i = 0, S = chunks.size(); i < S; ++i) {
+      free(chunks[i].data);
+    }
+    chunks.clear();
+  }
+
+  char* Memory_Manager::allocate_chunk(size_t size)
+  {
+    // huge objects get a dedicated chunk
+    // we keep bumping in the current one
+    if (size > SASS_MEM_CHUNK_MAX / 2) {
+      Memory_Chunk chunk = { static_cast<char*>(malloc(size)), size };
+      if (chunk.data == 0) throw std::bad_alloc();
+      chunks.push_back(chunk);
+      return chunk.data;
+    }
+    // make sure the chunk fits the request
+    while (next_chunk_size < size) next_chunk_size *= 2;
+    Memory_Chunk chunk = { static_cast<char*>(malloc(next_chunk_size)), next_chunk_size };
+    if (chunk.data == 0) throw std::bad_alloc();
+    chunks.push_back(chunk);
+    // grow chunks up to the limit
+    if (next_chunk_size < SASS_MEM_CHUNK_MAX) next_chunk_size *= 2;
+    // start bumping in the new chunk
+    cur = chunk.data + size;
+    end = chunk.data + chunk.size;
+    return chunk.data;
   }
 
-  Memory_Object* Memory_Manager::add(Memory_Object* np)
+  Memory_Object* Memory_Manager::add(Memory_Object* np, size_t size)
   {
     // object has been initialized
     // it can be "deleted" from now on
     np->refcount = 1;
+    // remember the allocated size
+    np->size = uint32_t(align_size(size));
+    // add the object under our management
+    np->slot = uint32_t(nodes.size());
+    nodes.push_back(np);
     return np;
   }
 
   bool Memory_Manager::has(Memory_Object* np)
   {
     // check if the pointer is controlled under our pool
-    return find(nodes.begin(), nodes.end(), np) != nodes.end();
+    return np->slot < nodes.size() && nodes[np->slot] == np;
   }
 
   Memory_Object* Memory_Manager::allocate(size_t size)
   {
-    // allocate requested memory
-    void* heap = malloc(size);
-    // init internal refcount status to zero
-    (static_cast<Memory_Object*>(heap))->refcount = 0;
-    // add the memory under our management
-    nodes.push_back(static_cast<Memory_Object*>(heap));
+    size = align_size(size);
+    // try to reuse memory from destroyed nodes
+    // otherwise bump the pointer if the object fits
+    // otherwise we need to get a new chunk
+    void* heap = 0;
+    size_t idx = size / SASS_MEM_ALIGN;
+    if (idx < free_lists.size() && free_lists[idx]) {
+      heap = free_lists[idx];
+      free_lists[idx] = *static_cast<void**>(heap);
+    } else if (size_t(end - cur) >= size) {
+      heap = cur;
+      cur += size;
+    } else {
+      heap = allocate_chunk(size);
+    }
+    // update statistics
+    bytes_allocated += size;
+    nodes_allocated += 1;
     // cast object to its initial type
     return static_cast<Memory_Object*>(heap);
   }
@@ -54,24 +123,51 @@ namespace Sass {
   {
     // only call destructor if initialized
     if (np->refcount) np->~Memory_Object();
-    // always free the memory
-    free(np);
+    // memory is owned by the chunks
   }
 
   void Memory_Manager::remove(Memory_Object* np)
   {
+    // nodes of other pools (like cached sheets) have
+    // a slot there, swapping it would corrupt ours
+    if (!has(np)) return;
+    // move last node into the free slot
+    Memory_Object* last = nodes.back();
+    nodes[np->slot] = last;
+    last->slot = np->slot;
     // remove node from pool (no longer active)
-    nodes.erase(find(nodes.begin(), nodes.end(), np));
-    // you are now in control of the memory
+    nodes.pop_back();
+    // you are now in control of the object
+    // memory is released with the chunks
   }
 
   void Memory_Manager::destroy(Memory_Object* np)
   {
+    // never release memory of other pools
+    if (!has(np)) return;
+    size_t size = np->size;
     // remove from pool
     remove(np);
-    // release memory
+    // release object
     deallocate(np);
+    // put memory on the free list for reuse
+    size_t idx = size / SASS_MEM_ALIGN;
+    if (size <= SASS_MEM_RECYCLE_MAX) {
+      // create the free lists on demand
+      if (free_lists.empty()) free_lists.resize(SASS_MEM_RECYCLE_MAX / SASS_MEM_ALIGN + 1, 0);
+      *reinterpret_cast<void**>(np) = free_lists[idx];
+      free_lists[idx] = np;
+    }
   }
 
-}
+  size_t Memory_Manager::reserved() const
+  {
+    // sum up the size of all chunks
+    size_t size = 0;
+    for (size_t i = 0, S = chunks.size(); i < S; ++i) {
+      size += chunks[i].size;
+    }
+    return size;
+  }
 
+}
@@ -2,14 +2,20 @@
 #define SASS_MEMORY_MANAGER_H
 
 #include <vector>
+#include <cstddef>
+#include <stdint.h>
 
 namespace Sass {
 
   class Memory_Object {
   friend class Memory_Manager;
     long refcount;
+    // position in the managers node list
+    uint32_t slot;
+    // aligned size of the allocation
+    uint32_t size;
   public:
-    Memory_Object() { refcount = 0; };
+    Memory_Object() { refcount = 0; slot = 0; size = 0; };
     virtual ~Memory_Object() {};
   };
 
@@ -18,10 +24,43 @@ namespace Sass {
   // is something like: Some_Node* n = new (mem_mgr) Some_Node(...);
   // Then, at the end of the program, the memory manager will delete all of the
   // allocated nodes that have been passed to it.
-  // In the future, this class may implement a custom allocator.
+  // Nodes are carved out of larger chunks (bump-pointer arena), so we only
+  // pay one malloc per chunk and can release all chunks at once. We still
+  // keep a list of all nodes, since their destructors must be invoked.
+  // Every node knows its slot in that list, so removing a node is O(1).
+  // Memory of destroyed nodes is put on a free list for its size class.
   /////////////////////////////////////////////////////////////////////////////
   class Memory_Manager {
+
+    // a single slab of raw memory
+    struct Memory_Chunk {
+      char* data;
+      size_t size;
+    };
+
     std::vector<Memory_Object*> nodes;
+    std::vector<Memory_Chunk> chunks;
+
+    // bump pointer into the current chunk
+    char* cur;
+    char* end;
+    // size for the next chunk we create
+    size_t next_chunk_size;
+
+    // free lists for recycled memory (by size class)
+    std::vector<void*> free_lists;
+
+    // statistics for this instance
+    size_t bytes_allocated;
+    size_t nodes_allocated;
+
+  private:
+    // get a new chunk with at least size bytes
+    char* allocate_chunk(size_t size);
+
+    // we own raw memory, never copy us
+    Memory_Manager(const Memory_Manager&);
+    Memory_Manager& operator=(const Memory_Manager&);
 
   public:
     Memory_Manager(size_t size = 0);
@@ -32,7 +71,12 @@ namespace Sass {
     void deallocate(Memory_Object* np);
     void remove(Memory_Object* np);
     void destroy(Memory_Object* np);
-    Memory_Object* add(Memory_Object* np);
+    Memory_Object* add(Memory_Object* np, size_t size);
+
+    // statistics for the current compilation
+    size_t bytes() const { return bytes_allocated; }
+    size_t count() const { return nodes_allocated; }
+    size_t reserved() const;
 
   };
 }
@@ -43,6 +87,6 @@ namespace Sass {
 ///////////////////////////////////////////////////////////////////////////////
 
 #define SASS_MEMORY_NEW(mgr, Class, ...)                                                 \
-  (static_cast<Class*>(mgr.add(new (mgr.allocate(sizeof(Class))) Class(__VA_ARGS__))))   \
+  (static_cast<Class*>(mgr.add(new (mgr.allocate(sizeof(Class))) Class(__VA_ARGS__), sizeof(Class)))) \
 
 #endif
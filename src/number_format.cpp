@@ -0,0 +1,303 @@
+#include "sass.hpp"
+#include <cmath>
+#include <locale>
+#include <sstream>
+#include <algorithm>
+#include <stdint.h>
+
+#include "number_format.hpp"
+
+namespace Sass {
+
+  static const uint64_t powers_of_ten[20] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+  };
+
+  // full 128 bit product of a and b
+  static void multiply(uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo)
+  {
+    uint64_t a0 = a & 0xFFFFFFFF, a1 = a >> 32;
+    uint64_t b0 = b & 0xFFFFFFFF, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1;
+    uint64_t p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+    lo = (mid << 32) | (p00 & 0xFFFFFFFF);
+    hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+  }
+
+  size_t format_fixed(double value, int digits, char* buffer)
+  {
+    if (digits < 0 || digits > 19) return 0;
+    if (!std::isfinite(value)) return 0;
+
+    // value scaled by 10^digits and rounded to an integer
+    uint64_t scaled = 0;
+    double abs = std::fabs(value);
+
+    if (abs != 0) {
+      // abs is exactly mantissa * 2^exponent
+      int exponent;
+      double fraction = std::frexp(abs, &exponent);
+      uint64_t mantissa = (uint64_t) std::ldexp(fraction, 53);
+      exponent -= 53;
+      while (!(mantissa & 1)) { mantissa >>= 1; ++ exponent; }
+
+      if (exponent >= 0) {
+        // no fraction, only needs to fit
+        if (exponent >= 64 || mantissa > (UINT64_MAX >> exponent)) return 0;
+        uint64_t integer = mantissa << exponent;
+        if (integer > UINT64_MAX / powers_of_ten[digits]) return 0;
+        scaled = integer * powers_of_ten[digits];
+      }
+      else {
+        // divide the exact product by 2^shift
+        // keep the remainder to round correctly
+        int shift = -exponent;
+        uint64_t hi, lo, rest_hi = 0, rest_lo = 0, half_hi = 0, half_lo = 0;
+        multiply(mantissa, powers_of_ten[digits], hi, lo);
+        if (shift >= 128) {
+          // product is below 2^117, so it rounds to zero
+          half_hi = 1;
+        }
+        else if (shift > 64) {
+          scaled = hi >> (shift - 64);
+          rest_hi = hi & ((1ULL << (shift - 64)) - 1);
+          rest_lo = lo;
+          half_hi = 1ULL << (shift - 65);
+        }
+        else if (shift == 64) {
+          scaled = hi;
+          rest_lo = lo;
+          half_lo = 1ULL << 63;
+        }
+        else {
+          if (hi >> shift) return 0;
+          scaled = (lo >> shift) | (hi << (64 - shift));
+          rest_lo = lo & ((1ULL << shift) - 1);
+          half_lo = 1ULL << (shift - 1);
+        }
+        // round half to even (like printf)
+        bool above = rest_hi != half_hi ? rest_hi > half_hi : rest_lo > half_lo;
+        bool tie = rest_hi == half_hi && rest_lo == half_lo;
+        if (above || (tie && (scaled & 1))) {
+          if (scaled == UINT64_MAX) return 0;
+          ++ scaled;
+        }
+      }
+    }
+
+    // collect digits in reverse order
+    char reversed[20];
+    int count = 0;
+    do {
+      reversed[count ++] = '0' + scaled % 10;
+      scaled /= 10;
+    } while (scaled);
+    // we always want one integer digit
+    while (count < digits + 1) reversed[count ++] = '0';
+
+    size_t len = 0;
+    if (std::signbit(value)) buffer[len ++] = '-';
+    for (int i = count - 1; i >= 0; -- i) {
+      buffer[len ++] = reversed[i];
+      if (i == digits && digits > 0) buffer[len ++] = '.';
+    }
+    return len;
+  }
+
+  // the original implementation via streams
+  // used for values the fast path cannot handle
+  static std::string format_number_stream(double value, int precision, bool strip_zero)
+  {
+
+    std::string res;
+
+    // this all cannot be done with one run only, since fixed
+    // output differs from normal output and regular output
+    // can contain scientific notation which we do not want!
+
+    // first sample
+    std::stringstream ss;
+    ss.imbue(std::locale::classic());
+    ss.precision(12);
+    ss << value;
+
+    // check if we got scientific notation in result
+    if (ss.str().find_first_of("e") != std::string::npos) {
+      ss.clear(); ss.str(std::string());
+      ss.precision(std::max(12, precision));
+      ss << std::fixed << value;
+    }
+
+    std::string tmp = ss.str();
+    size_t pos_point = tmp.find_first_of(".");
+    size_t pos_fract = tmp.find_last_not_of("0");
+    bool is_int = pos_point == pos_fract ||
+                  pos_point == std::string::npos;
+
+    // reset stream for another run
+    ss.clear(); ss.str(std::string());
+
+    // take a shortcut for integers
+    if (is_int)
+    {
+      ss.precision(0);
+      ss << std::fixed << value;
+      res = std::string(ss.str());
+    }
+    // process floats
+    else
+    {
+      // do we have have too much precision?
+      if (pos_fract < precision + pos_point)
+      { ss.precision((int)(pos_fract - pos_point)); }
+      else { ss.precision(precision); }
+      // round value again
+      ss << std::fixed << value;
+      res = std::string(ss.str());
+      // maybe we truncated up to decimal point
+      size_t pos = res.find_last_not_of("0");
+      // handle case where we have a "0"
+      if (pos == std::string::npos) {
+        res = "0.0";
+      } else {
+        bool at_dec_point = res[pos] == '.';
+        // don't leave a blank point
+        if (at_dec_point) ++ pos;
+        res.resize (pos + 1);
+      }
+    }
+
+    // some final cosmetics
+    if (res == "0.0") res = "0";
+    else if (res == "") res = "0";
+    else if (res == "-0") res = "0";
+    else if (res == "-0.0") res = "0";
+    else if (strip_zero)
+    {
+      // check if handling negative nr
+      size_t off = res[0] == '-' ? 1 : 0;
+      // remove leading zero from floating point
+      if (res[off] == '0' && res[off+1] == '.') res.erase(off, 1);
+    }
+
+    return res;
+  }
+
+  // decimal exponent of the first significant digit
+  // returns false if there is none (value is zero)
+  static bool leading_exponent(const char* fixed, size_t len, int& exponent)
+  {
+    size_t i = 0;
+    if (fixed[i] == '-') ++ i;
+    if (fixed[i] != '0') {
+      size_t start = i;
+      while (i < len && fixed[i] != '.') ++ i;
+      exponent = int(i - start) - 1;
+      return true;
+    }
+    for (i += 2; i < len; ++ i) {
+      if (fixed[i] != '0') {
+        exponent = - int(i - 1 - (fixed[0] == '-'));
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // number of fractional digits without trailing zeros
+  static int fractional_digits(const char* fixed, size_t len)
+  {
+    const char* point = std::find(fixed, fixed + len, '.');
+    if (point == fixed + len) return 0;
+    size_t last = len - 1;
+    while (fixed[last] == '0') -- last;
+    return int(fixed + last - point);
+  }
+
+  // Same result as the stream implementation above. The first sample is
+  // printed like "%.12g", which either gives us the value with twelve
+  // significant digits (fixed notation) or scientific notation. The
+  // number of fractional digits it has decides the final precision.
+  size_t format_number(double value, int precision, bool strip_zero, char* res)
+  {
+    if (precision < 0 || precision > 19 || !std::isfinite(value)) return 0;
+
+    char sample[FIXED_BUFFER_SIZE];
+    size_t sample_len = 0;
+    double abs = std::fabs(value);
+
+    // find the exponent after rounding to twelve digits
+    // our first guess may be off by one due to rounding
+    int exponent = abs == 0 ? 0 : (int) std::floor(std::log10(abs));
+    bool scientific = exponent < -6 || exponent > 11;
+    for (int tries = 0; !scientific; ++ tries) {
+      if (tries == 3) return 0;
+      sample_len = format_fixed(abs, 11 - exponent, sample);
+      if (sample_len == 0) return 0;
+      int rounded = 0;
+      // only zero has no significant digit
+      if (!leading_exponent(sample, sample_len, rounded)) break;
+      if (rounded == exponent) break;
+      exponent = rounded;
+      scientific = exponent < -4 || exponent > 11;
+    }
+    scientific = scientific || exponent < -4;
+
+    if (scientific) {
+      sample_len = format_fixed(value, std::max(12, precision), sample);
+      if (sample_len == 0) return 0;
+    }
+
+    size_t len = 0;
+    int digits = fractional_digits(sample, sample_len);
+
+    // take a shortcut for integers
+    if (digits == 0) {
+      len = format_fixed(value, 0, res);
+      if (len == 0) return 0;
+    }
+    // process floats
+    else {
+      len = format_fixed(value, std::min(digits, precision), res);
+      if (len == 0) return 0;
+      // maybe we truncated up to decimal point
+      size_t pos = len;
+      while (pos > 0 && res[pos - 1] == '0') -- pos;
+      // handle case where we have a "0"
+      if (pos == 0) {
+        std::copy(".0", ".0" + 2, res + 1);
+        len = 3;
+      } else {
+        // don't leave a blank point
+        if (res[pos - 1] == '.') ++ pos;
+        len = pos;
+      }
+    }
+
+    // some final cosmetics
+    size_t off = res[0] == '-' ? 1 : 0;
+    if (len - off == 1 && res[off] == '0') { res[0] = '0'; len = 1; }
+    else if (len - off == 3 && std::equal(res + off, res + len, "0.0")) { res[0] = '0'; len = 1; }
+    // remove leading zero from floating point
+    else if (strip_zero && res[off] == '0' && res[off+1] == '.') {
+      std::copy(res + off + 1, res + len, res + off);
+      -- len;
+    }
+
+    return len;
+  }
+
+  std::string format_number(double value, int precision, bool strip_zero)
+  {
+    char buffer[NUMBER_BUFFER_SIZE];
+    size_t len = format_number(value, precision, strip_zero, buffer);
+    if (len == 0) return format_number_stream(value, precision, strip_zero);
+    return std::string(buffer, len);
+  }
+
+}
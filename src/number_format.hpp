@@ -0,0 +1,31 @@
+#ifndef SASS_NUMBER_FORMAT_H
+#define SASS_NUMBER_FORMAT_H
+
+#include <string>
+
+namespace Sass {
+
+  // enough for all results of format_fixed
+  const size_t FIXED_BUFFER_SIZE = 48;
+
+  // writes value with the given fractional digits to buffer, same as
+  // printf("%.*f") in the C locale, but without locale or allocations
+  // returns the length or 0 if the value is not in range (digits > 19
+  // or more than 20 significant digits); nothing is terminated
+  size_t format_fixed(double value, int digits, char* buffer);
+
+  // enough for all results of format_number into a buffer
+  const size_t NUMBER_BUFFER_SIZE = FIXED_BUFFER_SIZE;
+
+  // formats a number value for output (without units) into buffer
+  // strip_zero removes the leading zero (compressed output)
+  // returns the length or 0 if the value needs the stream fallback
+  // (precision > 19, not finite or not in range of format_fixed)
+  size_t format_number(double value, int precision, bool strip_zero, char* buffer);
+
+  // same as above, but uses the stream fallback when needed
+  std::string format_number(double value, int precision, bool strip_zero);
+
+}
+
+#endif
@@ -7,7 +7,10 @@ namespace Sass {
   Output::Output(Sass_Output_Options& opt)
   : Inspect(Emitter(opt)),
     charset(""),
-    top_nodes(0)
+    top_nodes(0),
+    pending_imports(0),
+    pending_charset(false),
+    checked_ascii(0)
   {}
 
   Output::~Output() { }
@@ -32,7 +35,13 @@ namespace Sass {
 
   void Output::operator()(Import* imp)
   {
-    top_nodes.push_back(imp);
+    if (pending_imports) -- pending_imports;
+    // too late to move it to the top
+    if (written) {
+      Inspect::operator()(imp);
+      append_mandatory_linefeed();
+    }
+    else top_nodes.push_back(imp);
   }
 
   void Output::operator()(Map* m)
@@ -41,7 +50,29 @@ namespace Sass {
     error(dbg + " isn't a valid CSS value.", m->pstate());
   }
 
-  OutputBuffer Output::get_buffer(void)
+  static bool has_non_ascii(const char* begin, const char* end)
+  {
+    for (; begin != end; ++ begin) {
+      // static cast to unsigned to handle `char` being signed / unsigned
+      if (static_cast<unsigned>(*begin) >= 128) return true;
+    }
+    return false;
+  }
+
+  static bool has_non_ascii(const std::string& text)
+  {
+    return has_non_ascii(text.data(), text.data() + text.size());
+  }
+
+  static bool has_non_ascii(const std::vector<std::string>& segments)
+  {
+    for (const std::string& segment : segments) {
+      if (has_non_ascii(segment)) return true;
+    }
+    return false;
+  }
+
+  void Output::prepend_top_nodes(void)
   {
 
     Emitter emitter(opt);
@@ -52,39 +83,95 @@ namespace Sass {
       top_nodes[i]->perform(&inspect);
       inspect.append_mandatory_linefeed();
     }
+    top_nodes.clear();
 
     // flush scheduled outputs
     // maybe omit semicolon if possible
     inspect.finalize(wbuf.buffer.size() == 0);
     // prepend buffer on top
     prepend_output(inspect.output());
-    // make sure we end with a linefeed
-    if (!ends_with(wbuf.buffer, opt.linefeed)) {
-      // if the output is not completely empty
-      if (!wbuf.buffer.empty()) append_string(opt.linefeed);
-    }
+
+  }
+
+  void Output::prepend_charset(void)
+  {
 
     // search for unicode char
-    for(const char& chr : wbuf.buffer) {
-      // skip all ascii chars
-      // static cast to unsigned to handle `char` being signed / unsigned
-      if (static_cast<unsigned>(chr) < 128) continue;
+    if (has_non_ascii(wbuf.buffer) || has_non_ascii(wbuf.head) || has_non_ascii(wbuf.tail)) {
       // declare the charset
       if (output_style() != COMPRESSED)
         charset = "@charset \"UTF-8\";"
                 + std::string(opt.linefeed);
       else charset = "\xEF\xBB\xBF";
-      // abort search
-      break;
     }
 
     // add charset as first line, before comments and imports
     if (!charset.empty()) prepend_string(charset);
 
+  }
+
+  OutputBuffer& Output::get_buffer(void)
+  {
+
+    // otherwise done with the first chunk
+    if (written == 0) prepend_top_nodes();
+    // make sure we end with a linefeed
+    if (!wbuf.ends_with(opt.linefeed)) {
+      // if the output is not completely empty
+      if (!wbuf.empty()) append_string(opt.linefeed);
+    }
+    if (written == 0) prepend_charset();
+
     return wbuf;
 
   }
 
+  void Output::count_imports(Statement* stm)
+  {
+    if (dynamic_cast<Import*>(stm)) ++ pending_imports;
+    else if (Has_Block* b = dynamic_cast<Has_Block*>(stm)) {
+      if (Block* block = b->block()) {
+        for (size_t i = 0, L = block->length(); i < L; ++i) {
+          count_imports((*block)[i]);
+        }
+      }
+    }
+  }
+
+  // Buffered output decides on the charset and moves imports on
+  // top once everything is rendered. Streamed output has to know
+  // this before the first chunk, so it is held back until it can
+  // no longer change. Without non-ascii text in the sources (the
+  // caller knows) there is nothing to wait for. Otherwise we wait
+  // until non-ascii text is emitted, which is usually early.
+  void Output::prepare_stream(Block* root, bool may_have_non_ascii)
+  {
+    pending_charset = may_have_non_ascii;
+    for (size_t i = 0, L = root->length(); i < L; ++i) {
+      count_imports((*root)[i]);
+    }
+  }
+
+  // the first chunk is held back until now, as
+  // some nodes have to be moved to the top
+  void Output::flush_output(void)
+  {
+    if (written == 0) {
+      if (pending_imports) return;
+      if (!top_nodes.empty()) prepend_top_nodes();
+      if (pending_charset) {
+        // only look at the text added since the last check
+        const std::string& buffer(wbuf.buffer);
+        pending_charset = !has_non_ascii(wbuf.head) &&
+          !has_non_ascii(buffer.data() + checked_ascii, buffer.data() + buffer.size());
+        checked_ascii = buffer.size();
+        if (pending_charset) return;
+      }
+      prepend_charset();
+    }
+    Emitter::flush_output();
+  }
+
   void Output::operator()(Comment* c)
   {
     std::string txt = c->text()->to_string(opt);
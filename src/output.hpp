@@ -29,9 +29,26 @@ namespace Sass {
   protected:
     std::string charset;
     std::vector<AST_Node*> top_nodes;
+    // streamed output holds the first chunk back until
+    // all imports were visited (they go on top) and
+    size_t pending_imports;
+    // until non-ascii text appeared if the sources have any
+    bool pending_charset;
+    // buffer position checked for non-ascii text so far
+    size_t checked_ascii;
+
+  private:
+    // put collected top nodes and charset on top
+    void prepend_top_nodes(void);
+    void prepend_charset(void);
+    // count imports in the tree (they are moved on top)
+    void count_imports(Statement* stm);
 
   public:
-    OutputBuffer get_buffer(void);
+    OutputBuffer& get_buffer(void);
+    // decide what the first streamed chunk has to wait for
+    void prepare_stream(Block* root, bool may_have_non_ascii);
+    virtual void flush_output(void);
 
     virtual void operator()(Map*);
     virtual void operator()(Ruleset*);
@@ -0,0 +1,68 @@
+#include "sass.hpp"
+#include <atomic>
+#include <cstdlib>
+
+#include "parse_cache.hpp"
+
+namespace Sass {
+
+  // ids of cached sheets must not clash with the indexes of the resources
+  // of a context, since both end up in the parser states of the same tree
+  static std::atomic<size_t> source_id_counter(size_t(1) << (sizeof(size_t) * 4));
+
+  Parse_Cache::Sheet::Sheet(const std::string& key, const File::Stamp& stamp)
+  : key(key),
+    stamp(stamp),
+    source_id(source_id_counter++),
+    path(),
+    contents(0), srcmap(0),
+    mem(),
+    root(0),
+    imports(),
+    requests(),
+    cacheable(true),
+    busy(true)
+  { }
+
+  Parse_Cache::Sheet::~Sheet()
+  {
+    free(contents);
+    free(srcmap);
+  }
+
+  Parse_Cache::Parse_Cache()
+  : lock(), sheets()
+  { }
+
+  Parse_Cache::~Parse_Cache()
+  { }
+
+  Parse_Cache::Sheet_Ptr Parse_Cache::acquire(const std::string& key, const File::Stamp& stamp)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    std::unordered_map<std::string, Sheet_Ptr>::iterator it = sheets.find(key);
+    if (it == sheets.end()) return Sheet_Ptr();
+    Sheet_Ptr& sheet = it->second;
+    if (sheet->busy || !(sheet->stamp == stamp)) return Sheet_Ptr();
+    sheet->busy = true;
+    return sheet;
+  }
+
+  Parse_Cache::Sheet_Ptr Parse_Cache::create(const std::string& key, const File::Stamp& stamp)
+  {
+    return std::make_shared<Sheet>(key, stamp);
+  }
+
+  void Parse_Cache::insert(const Sheet_Ptr& sheet)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    sheets[sheet->key] = sheet;
+  }
+
+  void Parse_Cache::release(const Sheet_Ptr& sheet)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    sheet->busy = false;
+  }
+
+}
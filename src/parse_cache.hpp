@@ -0,0 +1,85 @@
+#ifndef SASS_PARSE_CACHE_H
+#define SASS_PARSE_CACHE_H
+
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "ast_fwd_decl.hpp"
+#include "memory_manager.hpp"
+#include "file.hpp"
+
+namespace Sass {
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Parsed style sheets shared between compilations (owned by compiler pools).
+  // Files are keyed by their absolute path and are checked against the stamp
+  // (mtime and size) on every lookup. Custom importers may opt in by setting
+  // a cache key on the returned import. A sheet owns its source and all nodes
+  // of the tree, so it outlives the context that parsed it. Evaluation still
+  // writes some state onto nodes (flags and function call caches), therefore
+  // a sheet is only handed to one compilation at a time. Other compilations
+  // will parse their own copy, which then replaces the busy one in the cache.
+  // Selectors are copied when evaluated, as later stages alter them in place.
+  // Imports of a cached sheet are restored as they were resolved on parsing.
+  /////////////////////////////////////////////////////////////////////////////
+  class Parse_Cache {
+  public:
+
+    class Sheet {
+    public:
+      // path or custom importer key
+      const std::string key;
+      // file stamp when it was read
+      const File::Stamp stamp;
+      // unique index for parser states
+      const size_t source_id;
+      // path for parser states
+      std::string path;
+      // owned source buffers
+      char* contents;
+      char* srcmap;
+      // owns all nodes
+      Memory_Manager mem;
+      // parsed root block
+      Block* root;
+      // direct imports in order
+      std::vector<Include> imports;
+      // the import paths as requested
+      std::vector<Importer> requests;
+      // false once a custom importer was involved
+      bool cacheable;
+      // handed to a compilation
+      bool busy;
+    public:
+      Sheet(const std::string& key, const File::Stamp& stamp);
+      ~Sheet();
+    };
+
+    typedef std::shared_ptr<Sheet> Sheet_Ptr;
+
+  private:
+    std::mutex lock;
+    std::unordered_map<std::string, Sheet_Ptr> sheets;
+
+  public:
+    Parse_Cache();
+    ~Parse_Cache();
+
+    // get a parsed sheet if it is unchanged and not busy
+    // the sheet is busy until it is given back via release
+    Sheet_Ptr acquire(const std::string& key, const File::Stamp& stamp);
+    // create a new (busy) sheet to parse into
+    Sheet_Ptr create(const std::string& key, const File::Stamp& stamp);
+    // make a parsed sheet available (replaces the old one)
+    void insert(const Sheet_Ptr& sheet);
+    // a compilation is done with the sheet
+    void release(const Sheet_Ptr& sheet);
+
+  };
+
+}
+
+#endif
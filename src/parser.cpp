@@ -1,5 +1,6 @@
 #include "sass.hpp"
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <vector>
 #include "parser.hpp"
@@ -33,11 +34,16 @@ namespace Sass {
 
   Parser Parser::from_c_str(const char* beg, Context& ctx, ParserState pstate, const char* source)
   {
-    Parser p(ctx, pstate);
+    return from_c_str(beg, ctx, ctx.mem, pstate, source);
+  }
+
+  Parser Parser::from_c_str(const char* beg, Context& ctx, Memory_Manager& mem, ParserState pstate, const char* source)
+  {
+    Parser p(ctx, mem, pstate);
     p.source   = source ? source : beg;
     p.position = beg ? beg : p.source;
     p.end      = p.position + strlen(p.position);
-    Block* root = SASS_MEMORY_NEW(ctx.mem, Block, pstate);
+    Block* root = SASS_MEMORY_NEW(mem, Block, pstate);
     p.block_stack.push_back(root);
     root->is_root(true);
     return p;
@@ -45,11 +51,16 @@ namespace Sass {
 
   Parser Parser::from_c_str(const char* beg, const char* end, Context& ctx, ParserState pstate, const char* source)
   {
-    Parser p(ctx, pstate);
+    return from_c_str(beg, end, ctx, ctx.mem, pstate, source);
+  }
+
+  Parser Parser::from_c_str(const char* beg, const char* end, Context& ctx, Memory_Manager& mem, ParserState pstate, const char* source)
+  {
+    Parser p(ctx, mem, pstate);
     p.source   = source ? source : beg;
     p.position = beg ? beg : p.source;
     p.end      = end ? end : p.position + strlen(p.position);
-    Block* root = SASS_MEMORY_NEW(ctx.mem, Block, pstate);
+    Block* root = SASS_MEMORY_NEW(mem, Block, pstate);
     p.block_stack.push_back(root);
     root->is_root(true);
     return p;
@@ -71,11 +82,16 @@ namespace Sass {
 
   Parser Parser::from_token(Token t, Context& ctx, ParserState pstate, const char* source)
   {
-    Parser p(ctx, pstate);
+    return from_token(t, ctx, ctx.mem, pstate, source);
+  }
+
+  Parser Parser::from_token(Token t, Context& ctx, Memory_Manager& mem, ParserState pstate, const char* source)
+  {
+    Parser p(ctx, mem, pstate);
     p.source   = source ? source : t.begin;
     p.position = t.begin ? t.begin : p.source;
     p.end      = t.end ? t.end : p.position + strlen(p.position);
-    Block* root = SASS_MEMORY_NEW(ctx.mem, Block, pstate);
+    Block* root = SASS_MEMORY_NEW(mem, Block, pstate);
     p.block_stack.push_back(root);
     root->is_root(true);
     return p;
@@ -85,7 +101,7 @@ namespace Sass {
   Block* Parser::parse()
   {
     bool is_root = false;
-    Block* root = SASS_MEMORY_NEW(ctx.mem, Block, pstate, 0, true);
+    Block* root = SASS_MEMORY_NEW(mem, Block, pstate, 0, true);
     read_bom();
 
     // custom headers
@@ -123,7 +139,7 @@ namespace Sass {
       css_error("Invalid CSS", " after ", ": expected \"{\", was ");
     }
     // create new block and push to the selector stack
-    Block* block = SASS_MEMORY_NEW(ctx.mem, Block, pstate, 0, is_root);
+    Block* block = SASS_MEMORY_NEW(mem, Block, pstate, 0, is_root);
     block_stack.push_back(block);
 
     if (!parse_block_nodes()) css_error("Invalid CSS", " after ", ": expected \"}\", was ");;
@@ -183,6 +199,51 @@ namespace Sass {
     return true;
   }
 
+  // directives parse_block_node has a dedicated matcher for
+  enum Block_Directive {
+    NO_DIRECTIVE,
+    ERROR_DIRECTIVE, DEBUG_DIRECTIVE, WARN_DIRECTIVE,
+    IF_DIRECTIVE, FOR_DIRECTIVE, EACH_DIRECTIVE, WHILE_DIRECTIVE,
+    RETURN_DIRECTIVE, IMPORT_DIRECTIVE, EXTEND_DIRECTIVE,
+    MEDIA_DIRECTIVE, AT_ROOT_DIRECTIVE, INCLUDE_DIRECTIVE,
+    CONTENT_DIRECTIVE, SUPPORTS_DIRECTIVE, MIXIN_DIRECTIVE,
+    FUNCTION_DIRECTIVE, CHARSET_DIRECTIVE
+  };
+
+  // perfect hash over the names above (see block_directive)
+  static const struct { const char* kwd; Block_Directive directive; } block_directives[32] = {
+    { 0, NO_DIRECTIVE }, { return_kwd, RETURN_DIRECTIVE }, { warn_kwd, WARN_DIRECTIVE },
+    { 0, NO_DIRECTIVE }, { 0, NO_DIRECTIVE }, { extend_kwd, EXTEND_DIRECTIVE },
+    { while_kwd, WHILE_DIRECTIVE }, { 0, NO_DIRECTIVE }, { for_kwd, FOR_DIRECTIVE },
+    { 0, NO_DIRECTIVE }, { error_kwd, ERROR_DIRECTIVE }, { 0, NO_DIRECTIVE },
+    { each_kwd, EACH_DIRECTIVE }, { media_kwd, MEDIA_DIRECTIVE }, { import_kwd, IMPORT_DIRECTIVE },
+    { 0, NO_DIRECTIVE }, { 0, NO_DIRECTIVE }, { mixin_kwd, MIXIN_DIRECTIVE },
+    { debug_kwd, DEBUG_DIRECTIVE }, { content_kwd, CONTENT_DIRECTIVE }, { charset_kwd, CHARSET_DIRECTIVE },
+    { 0, NO_DIRECTIVE }, { 0, NO_DIRECTIVE }, { function_kwd, FUNCTION_DIRECTIVE },
+    { 0, NO_DIRECTIVE }, { 0, NO_DIRECTIVE }, { at_root_kwd, AT_ROOT_DIRECTIVE },
+    { if_kwd, IF_DIRECTIVE }, { include_kwd, INCLUDE_DIRECTIVE }, { 0, NO_DIRECTIVE },
+    { supports_kwd, SUPPORTS_DIRECTIVE }, { 0, NO_DIRECTIVE }
+  };
+
+  // the only directive whose `word` matcher can match at src
+  // looks at the at-keyword once instead of trying them all
+  static Block_Directive block_directive(const char* src)
+  {
+    if (*src != '@') return NO_DIRECTIVE;
+    const char* name = src + 1;
+    const char* stop = name;
+    while (is_character(*stop)) ++ stop;
+    // no word boundary after the name
+    if (*stop == '#') return NO_DIRECTIVE;
+    size_t len = stop - name;
+    if (len < 2) return NO_DIRECTIVE;
+    const unsigned char* chr = reinterpret_cast<const unsigned char*>(name);
+    size_t hash = (len * 5 + chr[0] * 3 + chr[1] * 9) & 31;
+    const char* kwd = block_directives[hash].kwd;
+    if (!kwd || strncmp(kwd, src, len + 1) || kwd[len + 1]) return NO_DIRECTIVE;
+    return block_directives[hash].directive;
+  }
+
   // parser for a single node in a block
   // semicolons must be lexed beforehand
   bool Parser::parse_block_node(bool is_root) {
@@ -199,16 +260,21 @@ namespace Sass {
 
     // also parse block comments
 
+    // only try the matchers that can match
+    // the first bytes of the statement
+    bool at_rule = *position == '@';
+    Block_Directive directive = block_directive(position);
+
     // first parse everything that is allowed in functions
-    if (lex < variable >(true)) { (*block) << parse_assignment(); }
-    else if (lex < kwd_err >(true)) { (*block) << parse_error(); }
-    else if (lex < kwd_dbg >(true)) { (*block) << parse_debug(); }
-    else if (lex < kwd_warn >(true)) { (*block) << parse_warning(); }
-    else if (lex < kwd_if_directive >(true)) { (*block) << parse_if_directive(); }
-    else if (lex < kwd_for_directive >(true)) { (*block) << parse_for_directive(); }
-    else if (lex < kwd_each_directive >(true)) { (*block) << parse_each_directive(); }
-    else if (lex < kwd_while_directive >(true)) { (*block) << parse_while_directive(); }
-    else if (lex < kwd_return_directive >(true)) { (*block) << parse_return_directive(); }
+    if (*position == '$' && lex < variable >(true)) { (*block) << parse_assignment(); }
+    else if (directive == ERROR_DIRECTIVE && lex < kwd_err >(true)) { (*block) << parse_error(); }
+    else if (directive == DEBUG_DIRECTIVE && lex < kwd_dbg >(true)) { (*block) << parse_debug(); }
+    else if (directive == WARN_DIRECTIVE && lex < kwd_warn >(true)) { (*block) << parse_warning(); }
+    else if (directive == IF_DIRECTIVE && lex < kwd_if_directive >(true)) { (*block) << parse_if_directive(); }
+    else if (directive == FOR_DIRECTIVE && lex < kwd_for_directive >(true)) { (*block) << parse_for_directive(); }
+    else if (directive == EACH_DIRECTIVE && lex < kwd_each_directive >(true)) { (*block) << parse_each_directive(); }
+    else if (directive == WHILE_DIRECTIVE && lex < kwd_while_directive >(true)) { (*block) << parse_while_directive(); }
+    else if (directive == RETURN_DIRECTIVE && lex < kwd_return_directive >(true)) { (*block) << parse_return_directive(); }
 
     // abort if we are in function context and have nothing parsed yet
     else if (stack.back() == Scope::Function) {
@@ -216,7 +282,7 @@ namespace Sass {
     }
 
     // parse imports to process later
-    else if (lex < kwd_import >(true)) {
+    else if (directive == IMPORT_DIRECTIVE && lex < kwd_import >(true)) {
       Scope parent = stack.empty() ? Scope::Rules : stack.back();
       if (parent != Scope::Function && parent != Scope::Root && parent != Scope::Rules && parent != Scope::Media) {
         if (! peek_css< uri_prefix >(position)) { // this seems to go in ruby sass 3.4.20
@@ -228,11 +294,11 @@ namespace Sass {
       if (!imp->urls().empty()) (*block) << imp;
       // process all resources now (add Import_Stub nodes)
       for (size_t i = 0, S = imp->incs().size(); i < S; ++i) {
-        (*block) << SASS_MEMORY_NEW(ctx.mem, Import_Stub, pstate, imp->incs()[i]);
+        (*block) << SASS_MEMORY_NEW(mem, Import_Stub, pstate, imp->incs()[i]);
       }
     }
 
-    else if (lex < kwd_extend >(true)) {
+    else if (directive == EXTEND_DIRECTIVE && lex < kwd_extend >(true)) {
       if (block->is_root()) {
         error("Extend directives may only be used within rules.", pstate);
       }
@@ -242,29 +308,30 @@ namespace Sass {
       Selector* target;
       if (lookahead.has_interpolants) target = parse_selector_schema(lookahead.found);
       else                            target = parse_selector_list(true);
-      (*block) << SASS_MEMORY_NEW(ctx.mem, Extension, pstate, target);
+      (*block) << SASS_MEMORY_NEW(mem, Extension, pstate, target);
     }
 
     // selector may contain interpolations which need delayed evaluation
-    else if (!(lookahead_result = lookahead_for_selector(position)).error)
+    // no selector starts with an at sign, so skip the lookahead for them
+    else if (!at_rule && !(lookahead_result = lookahead_for_selector(position)).error)
     { (*block) << parse_ruleset(lookahead_result, is_root); }
 
     // parse multiple specific keyword directives
-    else if (lex < kwd_media >(true)) { (*block) << parse_media_block(); }
-    else if (lex < kwd_at_root >(true)) { (*block) << parse_at_root_block(); }
-    else if (lex < kwd_include_directive >(true)) { (*block) << parse_include_directive(); }
-    else if (lex < kwd_content_directive >(true)) { (*block) << parse_content_directive(); }
-    else if (lex < kwd_supports_directive >(true)) { (*block) << parse_supports_directive(); }
-    else if (lex < kwd_mixin >(true)) { (*block) << parse_definition(Definition::MIXIN); }
-    else if (lex < kwd_function >(true)) { (*block) << parse_definition(Definition::FUNCTION); }
+    else if (directive == MEDIA_DIRECTIVE && lex < kwd_media >(true)) { (*block) << parse_media_block(); }
+    else if (directive == AT_ROOT_DIRECTIVE && lex < kwd_at_root >(true)) { (*block) << parse_at_root_block(); }
+    else if (directive == INCLUDE_DIRECTIVE && lex < kwd_include_directive >(true)) { (*block) << parse_include_directive(); }
+    else if (directive == CONTENT_DIRECTIVE && lex < kwd_content_directive >(true)) { (*block) << parse_content_directive(); }
+    else if (directive == SUPPORTS_DIRECTIVE && lex < kwd_supports_directive >(true)) { (*block) << parse_supports_directive(); }
+    else if (directive == MIXIN_DIRECTIVE && lex < kwd_mixin >(true)) { (*block) << parse_definition(Definition::MIXIN); }
+    else if (directive == FUNCTION_DIRECTIVE && lex < kwd_function >(true)) { (*block) << parse_definition(Definition::FUNCTION); }
 
     // ignore the @charset directive for now
-    else if (lex< kwd_charset_directive >(true)) { parse_charset_directive(); }
+    else if (directive == CHARSET_DIRECTIVE && lex< kwd_charset_directive >(true)) { parse_charset_directive(); }
 
     // generic at keyword (keep last)
-    else if (lex< re_special_directive >(true)) { (*block) << parse_special_directive(); }
+    else if (at_rule && lex< re_special_directive >(true)) { (*block) << parse_special_directive(); }
     else if (lex< re_prefixed_directive >(true)) { (*block) << parse_prefixed_directive(); }
-    else if (lex< at_keyword >(true)) { (*block) << parse_directive(); }
+    else if (at_rule && lex< at_keyword >(true)) { (*block) << parse_directive(); }
 
     else if (block->is_root()) {
       lex< css_whitespace >();
@@ -297,7 +364,7 @@ namespace Sass {
   // parse imports inside the
   Import* Parser::parse_import()
   {
-    Import* imp = SASS_MEMORY_NEW(ctx.mem, Import, pstate);
+    Import* imp = SASS_MEMORY_NEW(mem, Import, pstate);
     std::vector<std::pair<std::string,Function_Call*>> to_import;
     bool first = true;
     do {
@@ -306,15 +373,15 @@ namespace Sass {
         to_import.push_back(std::pair<std::string,Function_Call*>(std::string(lexed), 0));
       }
       else if (lex< uri_prefix >()) {
-        Arguments* args = SASS_MEMORY_NEW(ctx.mem, Arguments, pstate);
-        Function_Call* result = SASS_MEMORY_NEW(ctx.mem, Function_Call, pstate, "url", args);
+        Arguments* args = SASS_MEMORY_NEW(mem, Arguments, pstate);
+        Function_Call* result = SASS_MEMORY_NEW(mem, Function_Call, pstate, "url", args);
 
         if (lex< quoted_string >()) {
           Expression* the_url = parse_string();
-          *args << SASS_MEMORY_NEW(ctx.mem, Argument, the_url->pstate(), the_url);
+          *args << SASS_MEMORY_NEW(mem, Argument, the_url->pstate(), the_url);
         }
         else if (String* the_url = parse_url_function_argument()) {
-          *args << SASS_MEMORY_NEW(ctx.mem, Argument, the_url->pstate(), the_url);
+          *args << SASS_MEMORY_NEW(mem, Argument, the_url->pstate(), the_url);
         }
         else {
           error("malformed URL", pstate);
@@ -367,7 +434,7 @@ namespace Sass {
     else stack.push_back(Scope::Function);
     Block* body = parse_block();
     stack.pop_back();
-    Definition* def = SASS_MEMORY_NEW(ctx.mem, Definition, source_position_of_def, name, params, body, which_type);
+    Definition* def = SASS_MEMORY_NEW(mem, Definition, source_position_of_def, name, params, body, which_type);
     return def;
   }
 
@@ -375,7 +442,7 @@ namespace Sass {
   {
     std::string name(lexed);
     Position position = after_token;
-    Parameters* params = SASS_MEMORY_NEW(ctx.mem, Parameters, pstate);
+    Parameters* params = SASS_MEMORY_NEW(mem, Parameters, pstate);
     if (lex_css< exactly<'('> >()) {
       // if there's anything there at all
       if (!peek_css< exactly<')'> >()) {
@@ -403,7 +470,7 @@ namespace Sass {
     else if (lex< exactly< ellipsis > >()) {
       is_rest = true;
     }
-    Parameter* p = SASS_MEMORY_NEW(ctx.mem, Parameter, pos, name, val, is_rest);
+    Parameter* p = SASS_MEMORY_NEW(mem, Parameter, pos, name, val, is_rest);
     return p;
   }
 
@@ -411,7 +478,7 @@ namespace Sass {
   {
     std::string name(lexed);
     Position position = after_token;
-    Arguments* args = SASS_MEMORY_NEW(ctx.mem, Arguments, pstate);
+    Arguments* args = SASS_MEMORY_NEW(mem, Arguments, pstate);
     if (lex_css< exactly<'('> >()) {
       // if there's anything there at all
       if (!peek_css< exactly<')'> >()) {
@@ -437,7 +504,7 @@ namespace Sass {
       ParserState p = pstate;
       lex_css< exactly<':'> >();
       Expression* val = parse_space_list();
-      arg = SASS_MEMORY_NEW(ctx.mem, Argument, p, val, name);
+      arg = SASS_MEMORY_NEW(mem, Argument, p, val, name);
     }
     else {
       bool is_arglist = false;
@@ -450,7 +517,7 @@ namespace Sass {
         )) is_keyword = true;
         else is_arglist = true;
       }
-      arg = SASS_MEMORY_NEW(ctx.mem, Argument, pstate, val, "", is_arglist, is_keyword);
+      arg = SASS_MEMORY_NEW(mem, Argument, pstate, val, "", is_arglist, is_keyword);
     }
     return arg;
   }
@@ -473,7 +540,7 @@ namespace Sass {
       if (lex< default_flag >()) is_default = true;
       else if (lex< global_flag >()) is_global = true;
     }
-    Assignment* var = SASS_MEMORY_NEW(ctx.mem, Assignment, var_source_position, name, val, is_default, is_global);
+    Assignment* var = SASS_MEMORY_NEW(mem, Assignment, var_source_position, name, val, is_default, is_global);
     return var;
   }
 
@@ -483,7 +550,7 @@ namespace Sass {
     // make sure to move up the the last position
     lex < optional_css_whitespace >(false, true);
     // create the connector object (add parts later)
-    Ruleset* ruleset = SASS_MEMORY_NEW(ctx.mem, Ruleset, pstate);
+    Ruleset* ruleset = SASS_MEMORY_NEW(mem, Ruleset, pstate);
     // parse selector static or as schema to be evaluated later
     if (lookahead.parsable) ruleset->selector(parse_selector_list(is_root));
     else ruleset->selector(parse_selector_schema(lookahead.found));
@@ -509,9 +576,9 @@ namespace Sass {
     lex< optional_spaces >();
     const char* i = position;
     // selector schema re-uses string schema implementation
-    String_Schema* schema = SASS_MEMORY_NEW(ctx.mem, String_Schema, pstate);
+    String_Schema* schema = SASS_MEMORY_NEW(mem, String_Schema, pstate);
     // the selector schema is pretty much just a wrapper for the string schema
-    Selector_Schema* selector_schema = SASS_MEMORY_NEW(ctx.mem, Selector_Schema, pstate, schema);
+    Selector_Schema* selector_schema = SASS_MEMORY_NEW(mem, Selector_Schema, pstate, schema);
     selector_schema->media_block(last_media_block);
 
     // process until end
@@ -519,7 +586,7 @@ namespace Sass {
       // try to parse mutliple interpolants
       if (const char* p = find_first_in_interval< exactly<hash_lbrace>, block_comment >(i, end_of_selector)) {
         // accumulate the preceding segment if the position has advanced
-        if (i < p) (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, std::string(i, p));
+        if (i < p) (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, std::string(i, p));
         // check if the interpolation only contains white-space (error out)
         if (peek < sequence < optional_spaces, exactly<rbrace> > >(p+2)) { position = p+2;
           css_error("Invalid CSS", " after ", ": expected expression (e.g. 1px, bold), was ");
@@ -527,7 +594,7 @@ namespace Sass {
         // skip over all nested inner interpolations up to our own delimiter
         const char* j = skip_over_scopes< exactly<hash_lbrace>, exactly<rbrace> >(p + 2, end_of_selector);
         // pass inner expression to the parser to resolve nested interpolations
-        Expression* interpolant = Parser::from_c_str(p+2, j, ctx, pstate).parse_list();
+        Expression* interpolant = Parser::from_c_str(p+2, j, ctx, mem, pstate).parse_list();
         // set status on the list expression
         interpolant->is_interpolant(true);
         // schema->has_interpolants(true);
@@ -540,7 +607,7 @@ namespace Sass {
       // add the last segment if there is one
       else {
         // make sure to add the last bits of the string up to the end (if any)
-        if (i < end_of_selector) (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, std::string(i, end_of_selector));
+        if (i < end_of_selector) (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, std::string(i, end_of_selector));
         // exit loop
         i = end_of_selector;
       }
@@ -577,7 +644,7 @@ namespace Sass {
     // normalize underscores to hyphens
     std::string name(Util::normalize_underscores(lexed));
     // create the initial mixin call object
-    Mixin_Call* call = SASS_MEMORY_NEW(ctx.mem, Mixin_Call, pstate, name, 0, 0);
+    Mixin_Call* call = SASS_MEMORY_NEW(mem, Mixin_Call, pstate, name, 0, 0);
     // parse mandatory arguments
     call->arguments(parse_arguments());
     // parse optional block
@@ -596,7 +663,7 @@ namespace Sass {
     bool reloop = true;
     bool had_linefeed = false;
     Sequence_Selector* sel = 0;
-    CommaSequence_Selector* group = SASS_MEMORY_NEW(ctx.mem, CommaSequence_Selector, pstate);
+    CommaSequence_Selector* group = SASS_MEMORY_NEW(mem, CommaSequence_Selector, pstate);
     group->media_block(last_media_block);
 
     do {
@@ -668,7 +735,7 @@ namespace Sass {
       // comments are allowed, but not spaces?
       combinator = Sequence_Selector::REFERENCE;
       if (!lex < re_reference_combinator >()) return 0;
-      reference = SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+      reference = SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
       if (!lex < exactly < '/' > >()) return 0; // ToDo: error msg?
     }
     else /* if (lex< zero >()) */   combinator = Sequence_Selector::ANCESTOR_OF;
@@ -678,7 +745,7 @@ namespace Sass {
     // lex < block_comment >();
     // source position of a complex selector points to the combinator
     // ToDo: make sure we update pstate for ancestor of (lex < zero >());
-    Sequence_Selector* sel = SASS_MEMORY_NEW(ctx.mem, Sequence_Selector, pstate, combinator, lhs);
+    Sequence_Selector* sel = SASS_MEMORY_NEW(mem, Sequence_Selector, pstate, combinator, lhs);
     sel->media_block(last_media_block);
 
     if (combinator == Sequence_Selector::REFERENCE) sel->reference(reference);
@@ -701,9 +768,9 @@ namespace Sass {
     // also skip adding parent ref if we only have refs
     if (!sel->has_parent_ref() && !in_at_root && !in_root) {
       // create the objects to wrap parent selector reference
-      Parent_Selector* parent = SASS_MEMORY_NEW(ctx.mem, Parent_Selector, pstate);
+      Parent_Selector* parent = SASS_MEMORY_NEW(mem, Parent_Selector, pstate);
       parent->media_block(last_media_block);
-      SimpleSequence_Selector* head = SASS_MEMORY_NEW(ctx.mem, SimpleSequence_Selector, pstate);
+      SimpleSequence_Selector* head = SASS_MEMORY_NEW(mem, SimpleSequence_Selector, pstate);
       head->media_block(last_media_block);
       // add simple selector
       (*head) << parent;
@@ -711,7 +778,7 @@ namespace Sass {
       if (!sel->head()) { sel->head(head); }
       // otherwise we need to create a new complex selector and set the old one as its tail
       else {
-        sel = SASS_MEMORY_NEW(ctx.mem, Sequence_Selector, pstate, Sequence_Selector::ANCESTOR_OF, head, sel);
+        sel = SASS_MEMORY_NEW(mem, Sequence_Selector, pstate, Sequence_Selector::ANCESTOR_OF, head, sel);
         sel->media_block(last_media_block);
       }
       // peek for linefeed and remember result on head
@@ -729,7 +796,7 @@ namespace Sass {
   SimpleSequence_Selector* Parser::parse_compound_selector()
   {
     // init an empty compound selector wrapper
-    SimpleSequence_Selector* seq = SASS_MEMORY_NEW(ctx.mem, SimpleSequence_Selector, pstate);
+    SimpleSequence_Selector* seq = SASS_MEMORY_NEW(mem, SimpleSequence_Selector, pstate);
     seq->media_block(last_media_block);
 
     // skip initial white-space
@@ -750,7 +817,7 @@ namespace Sass {
       {
         // this produces a linefeed!?
         seq->has_parent_reference(true);
-        (*seq) << SASS_MEMORY_NEW(ctx.mem, Parent_Selector, pstate);
+        (*seq) << SASS_MEMORY_NEW(mem, Parent_Selector, pstate);
         // parent selector only allowed at start
         // upcoming Sass may allow also trailing
         if (seq->length() > 1) {
@@ -767,7 +834,7 @@ namespace Sass {
       // parse type selector
       else if (lex< re_type_selector >(false))
       {
-        (*seq) << SASS_MEMORY_NEW(ctx.mem, Element_Selector, pstate, lexed);
+        (*seq) << SASS_MEMORY_NEW(mem, Element_Selector, pstate, lexed);
       }
       // peek for abort conditions
       else if (peek< spaces >()) break;
@@ -796,16 +863,16 @@ namespace Sass {
   {
     lex < css_comments >(false);
     if (lex< class_name >()) {
-      return SASS_MEMORY_NEW(ctx.mem, Class_Selector, pstate, lexed);
+      return SASS_MEMORY_NEW(mem, Class_Selector, pstate, lexed);
     }
     else if (lex< id_name >()) {
-      return SASS_MEMORY_NEW(ctx.mem, Id_Selector, pstate, lexed);
+      return SASS_MEMORY_NEW(mem, Id_Selector, pstate, lexed);
     }
     else if (lex< quoted_string >()) {
-      return SASS_MEMORY_NEW(ctx.mem, Element_Selector, pstate, unquote(lexed));
+      return SASS_MEMORY_NEW(mem, Element_Selector, pstate, unquote(lexed));
     }
     else if (lex< alternatives < variable, number, static_reference_combinator > >()) {
-      return SASS_MEMORY_NEW(ctx.mem, Element_Selector, pstate, lexed);
+      return SASS_MEMORY_NEW(mem, Element_Selector, pstate, lexed);
     }
     else if (peek< pseudo_not >()) {
       return parse_negated_selector();
@@ -820,7 +887,7 @@ namespace Sass {
       return parse_attribute_selector();
     }
     else if (lex< placeholder >()) {
-      Placeholder_Selector* sel = SASS_MEMORY_NEW(ctx.mem, Placeholder_Selector, pstate, lexed);
+      Placeholder_Selector* sel = SASS_MEMORY_NEW(mem, Placeholder_Selector, pstate, lexed);
       sel->media_block(last_media_block);
       return sel;
     }
@@ -838,7 +905,7 @@ namespace Sass {
       error("negated selector is missing ')'", pstate);
     }
     name.erase(name.size() - 1);
-    return SASS_MEMORY_NEW(ctx.mem, Wrapped_Selector, nsource_position, name, negated);
+    return SASS_MEMORY_NEW(mem, Wrapped_Selector, nsource_position, name, negated);
   }
 
   // a pseudo selector often starts with one or two colons
@@ -871,15 +938,15 @@ namespace Sass {
           >()
       ) {
         lex_css< alternatives < static_value, binomial > >();
-        String_Constant* expr = SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+        String_Constant* expr = SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
         if (expr && lex_css< exactly<')'> >()) {
           expr->can_compress_whitespace(true);
-          return SASS_MEMORY_NEW(ctx.mem, Pseudo_Selector, p, name, expr);
+          return SASS_MEMORY_NEW(mem, Pseudo_Selector, p, name, expr);
         }
       }
       else if (Selector* wrapped = parse_selector_list(true)) {
         if (wrapped && lex_css< exactly<')'> >()) {
-          return SASS_MEMORY_NEW(ctx.mem, Wrapped_Selector, p, name, wrapped);
+          return SASS_MEMORY_NEW(mem, Wrapped_Selector, p, name, wrapped);
         }
       }
 
@@ -887,7 +954,7 @@ namespace Sass {
     // EO if pseudo selector
 
     else if (lex < sequence< optional < pseudo_prefix >, identifier > >()) {
-      return SASS_MEMORY_NEW(ctx.mem, Pseudo_Selector, pstate, lexed);
+      return SASS_MEMORY_NEW(mem, Pseudo_Selector, pstate, lexed);
     }
     else if(lex < pseudo_prefix >()) {
       css_error("Invalid CSS", " after ", ": expected pseudoclass or pseudoelement, was ");
@@ -904,7 +971,7 @@ namespace Sass {
     ParserState p = pstate;
     if (!lex_css< attribute_name >()) error("invalid attribute name in attribute selector", pstate);
     std::string name(lexed);
-    if (lex_css< alternatives < exactly<']'>, exactly<'/'> > >()) return SASS_MEMORY_NEW(ctx.mem, Attribute_Selector, p, name, "", 0);
+    if (lex_css< alternatives < exactly<']'>, exactly<'/'> > >()) return SASS_MEMORY_NEW(mem, Attribute_Selector, p, name, "", 0);
     if (!lex_css< alternatives< exact_match, class_match, dash_match,
                                 prefix_match, suffix_match, substring_match > >()) {
       error("invalid operator in attribute selector for " + name, pstate);
@@ -913,7 +980,7 @@ namespace Sass {
 
     String* value = 0;
     if (lex_css< identifier >()) {
-      value = SASS_MEMORY_NEW(ctx.mem, String_Constant, p, lexed);
+      value = SASS_MEMORY_NEW(mem, String_Constant, p, lexed);
     }
     else if (lex_css< quoted_string >()) {
       value = parse_interpolated_chunk(lexed, true); // needed!
@@ -923,7 +990,7 @@ namespace Sass {
     }
 
     if (!lex_css< alternatives < exactly<']'>, exactly<'/'> > >()) error("unterminated attribute selector for " + name, pstate);
-    return SASS_MEMORY_NEW(ctx.mem, Attribute_Selector, p, name, matcher, value);
+    return SASS_MEMORY_NEW(mem, Attribute_Selector, p, name, matcher, value);
   }
 
   /* parse block comment and add to block */
@@ -934,7 +1001,7 @@ namespace Sass {
       bool is_important = lexed.begin[2] == '!';
       // flag on second param is to skip loosely over comments
       String*  contents = parse_interpolated_chunk(lexed, true);
-      (*block) << SASS_MEMORY_NEW(ctx.mem, Comment, pstate, contents, is_important);
+      (*block) << SASS_MEMORY_NEW(mem, Comment, pstate, contents, is_important);
     }
   }
 
@@ -944,7 +1011,7 @@ namespace Sass {
       prop = parse_identifier_schema();
     }
     else if (lex< sequence< optional< exactly<'*'> >, identifier, zero_plus< block_comment > > >()) {
-      prop = SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+      prop = SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
     }
     else {
       css_error("Invalid CSS", " after ", ": expected \"}\", was ");
@@ -956,7 +1023,7 @@ namespace Sass {
     if (peek_css< exactly<';'> >()) error("style declaration must contain a value", pstate);
     if (peek_css< exactly<'{'> >()) is_indented = false; // don't indent if value is empty
     if (peek_css< static_value >()) {
-      return SASS_MEMORY_NEW(ctx.mem, Declaration, prop->pstate(), prop, parse_static_value()/*, lex<kwd_important>()*/);
+      return SASS_MEMORY_NEW(mem, Declaration, prop->pstate(), prop, parse_static_value()/*, lex<kwd_important>()*/);
     }
     else {
       Expression* value;
@@ -977,7 +1044,7 @@ namespace Sass {
         }
       }
       lex < css_comments >(false);
-      auto decl = SASS_MEMORY_NEW(ctx.mem, Declaration, prop->pstate(), prop, value/*, lex<kwd_important>()*/);
+      auto decl = SASS_MEMORY_NEW(mem, Declaration, prop->pstate(), prop, value/*, lex<kwd_important>()*/);
       decl->is_indented(is_indented);
       return decl;
     }
@@ -1002,11 +1069,11 @@ namespace Sass {
   Expression* Parser::parse_map()
   {
     Expression* key = parse_list();
-    List* map = SASS_MEMORY_NEW(ctx.mem, List, pstate, 0, SASS_HASH);
+    List* map = SASS_MEMORY_NEW(mem, List, pstate, 0, SASS_HASH);
     if (String_Quoted* str = dynamic_cast<String_Quoted*>(key)) {
       if (!str->quote_mark() && !str->is_delayed()) {
         if (const Color* col = name_to_color(str->value())) {
-          Color* c = SASS_MEMORY_NEW(ctx.mem, Color, *col);
+          Color* c = SASS_MEMORY_NEW(mem, Color, *col);
           c->pstate(str->pstate());
           c->disp(str->value());
           key = c;
@@ -1032,7 +1099,7 @@ namespace Sass {
       if (String_Quoted* str = dynamic_cast<String_Quoted*>(key)) {
         if (!str->quote_mark() && !str->is_delayed()) {
           if (const Color* col = name_to_color(str->value())) {
-            Color* c = SASS_MEMORY_NEW(ctx.mem, Color, *col);
+            Color* c = SASS_MEMORY_NEW(mem, Color, *col);
             c->pstate(str->pstate());
             c->disp(str->value());
             key = c;
@@ -1082,7 +1149,7 @@ namespace Sass {
         > >(position))
     {
       // return an empty list (nothing to delay)
-      return SASS_MEMORY_NEW(ctx.mem, List, pstate, 0);
+      return SASS_MEMORY_NEW(mem, List, pstate, 0);
     }
 
     // now try to parse a space list
@@ -1096,7 +1163,7 @@ namespace Sass {
     }
 
     // if we got so far, we actually do have a comma list
-    List* comma_list = SASS_MEMORY_NEW(ctx.mem, List, pstate, 2, SASS_COMMA);
+    List* comma_list = SASS_MEMORY_NEW(mem, List, pstate, 2, SASS_COMMA);
     // wrap the first expression
     (*comma_list) << list;
 
@@ -1143,7 +1210,7 @@ namespace Sass {
         > >(position)
     ) { return disj1; }
 
-    List* space_list = SASS_MEMORY_NEW(ctx.mem, List, pstate, 2, SASS_SPACE);
+    List* space_list = SASS_MEMORY_NEW(mem, List, pstate, 2, SASS_SPACE);
     (*space_list) << disj1;
 
     while (!(peek_css< alternatives <
@@ -1358,17 +1425,17 @@ namespace Sass {
       return parse_function_call();
     }
     else if (lex< exactly<'+'> >()) {
-      return SASS_MEMORY_NEW(ctx.mem, Unary_Expression, pstate, Unary_Expression::PLUS, parse_factor());
+      return SASS_MEMORY_NEW(mem, Unary_Expression, pstate, Unary_Expression::PLUS, parse_factor());
     }
     else if (lex< exactly<'-'> >()) {
-      return SASS_MEMORY_NEW(ctx.mem, Unary_Expression, pstate, Unary_Expression::MINUS, parse_factor());
+      return SASS_MEMORY_NEW(mem, Unary_Expression, pstate, Unary_Expression::MINUS, parse_factor());
     }
     else if (lex< sequence< kwd_not > >()) {
-      return SASS_MEMORY_NEW(ctx.mem, Unary_Expression, pstate, Unary_Expression::NOT, parse_factor());
+      return SASS_MEMORY_NEW(mem, Unary_Expression, pstate, Unary_Expression::NOT, parse_factor());
     }
     else if (peek < sequence < one_plus < alternatives < css_whitespace, exactly<'-'>, exactly<'+'> > >, number > >()) {
       if (parse_number_prefix()) return parse_value(); // prefix is positive
-      return SASS_MEMORY_NEW(ctx.mem, Unary_Expression, pstate, Unary_Expression::MINUS, parse_value());
+      return SASS_MEMORY_NEW(mem, Unary_Expression, pstate, Unary_Expression::MINUS, parse_value());
     }
     else {
       return parse_value();
@@ -1381,17 +1448,17 @@ namespace Sass {
     lex< css_comments >(false);
     if (lex< ampersand >())
     {
-      return SASS_MEMORY_NEW(ctx.mem, Parent_Selector, pstate); }
+      return SASS_MEMORY_NEW(mem, Parent_Selector, pstate); }
 
     if (lex< kwd_important >())
-    { return SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, "!important"); }
+    { return SASS_MEMORY_NEW(mem, String_Constant, pstate, "!important"); }
 
     // parse `10%4px` into separated items and not a schema
     if (lex< sequence < percentage, lookahead < number > > >())
-    { return SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::PERCENTAGE, lexed); }
+    { return SASS_MEMORY_NEW(mem, Textual, pstate, Textual::PERCENTAGE, lexed); }
 
     if (lex< sequence < number, lookahead< sequence < op, number > > > >())
-    { return SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::NUMBER, lexed); }
+    { return SASS_MEMORY_NEW(mem, Textual, pstate, Textual::NUMBER, lexed); }
 
     // string may be interpolated
     if (lex< sequence < quoted_string, lookahead < exactly <'-'> > > >())
@@ -1405,45 +1472,45 @@ namespace Sass {
     { return parse_string(); }
 
     if (lex< kwd_true >())
-    { return SASS_MEMORY_NEW(ctx.mem, Boolean, pstate, true); }
+    { return SASS_MEMORY_NEW(mem, Boolean, pstate, true); }
 
     if (lex< kwd_false >())
-    { return SASS_MEMORY_NEW(ctx.mem, Boolean, pstate, false); }
+    { return SASS_MEMORY_NEW(mem, Boolean, pstate, false); }
 
     if (lex< kwd_null >())
-    { return SASS_MEMORY_NEW(ctx.mem, Null, pstate); }
+    { return SASS_MEMORY_NEW(mem, Null, pstate); }
 
     if (lex< identifier >()) {
-      return SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+      return SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
     }
 
     if (lex< percentage >())
-    { return SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::PERCENTAGE, lexed); }
+    { return SASS_MEMORY_NEW(mem, Textual, pstate, Textual::PERCENTAGE, lexed); }
 
     // match hex number first because 0x000 looks like a number followed by an identifier
     if (lex< sequence < alternatives< hex, hex0 >, negate < exactly<'-'> > > >())
-    { return SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::HEX, lexed); }
+    { return SASS_MEMORY_NEW(mem, Textual, pstate, Textual::HEX, lexed); }
 
     if (lex< sequence < exactly <'#'>, identifier > >())
-    { return SASS_MEMORY_NEW(ctx.mem, String_Quoted, pstate, lexed); }
+    { return SASS_MEMORY_NEW(mem, String_Quoted, pstate, lexed); }
 
     // also handle the 10em- foo special case
     // alternatives < exactly < '.' >, .. > -- `1.5em-.75em` is split into a list, not a binary expression
     if (lex< sequence< dimension, optional< sequence< exactly<'-'>, lookahead< alternatives < space > > > > > >())
-    { return SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::DIMENSION, lexed); }
+    { return SASS_MEMORY_NEW(mem, Textual, pstate, Textual::DIMENSION, lexed); }
 
     if (lex< sequence< static_component, one_plus< strict_identifier > > >())
-    { return SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed); }
+    { return SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed); }
 
     if (lex< number >())
-    { return SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::NUMBER, lexed); }
+    { return SASS_MEMORY_NEW(mem, Textual, pstate, Textual::NUMBER, lexed); }
 
     if (lex< variable >())
-    { return SASS_MEMORY_NEW(ctx.mem, Variable, pstate, Util::normalize_underscores(lexed)); }
+    { return SASS_MEMORY_NEW(mem, Variable, pstate, Util::normalize_underscores(lexed)); }
 
     // Special case handling for `%` proceeding an interpolant.
     if (lex< sequence< exactly<'%'>, optional< percentage > > >())
-    { return SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed); }
+    { return SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed); }
 
     css_error("Invalid CSS", " after ", ": expected expression (e.g. 1px, bold), was ");
 
@@ -1461,12 +1528,12 @@ namespace Sass {
                     find_first_in_interval< exactly<hash_lbrace>, block_comment >(i, chunk.end);
 
     if (!p) {
-      String_Quoted* str_quoted = SASS_MEMORY_NEW(ctx.mem, String_Quoted, pstate, std::string(i, chunk.end));
+      String_Quoted* str_quoted = SASS_MEMORY_NEW(mem, String_Quoted, pstate, std::string(i, chunk.end));
       if (!constant && str_quoted->quote_mark()) str_quoted->quote_mark('*');
       return str_quoted;
     }
 
-    String_Schema* schema = SASS_MEMORY_NEW(ctx.mem, String_Schema, pstate);
+    String_Schema* schema = SASS_MEMORY_NEW(mem, String_Schema, pstate);
     schema->is_interpolant(true);
     while (i < chunk.end) {
       p = constant ? find_first_in_interval< exactly<hash_lbrace> >(i, chunk.end) :
@@ -1474,7 +1541,7 @@ namespace Sass {
       if (p) {
         if (i < p) {
           // accumulate the preceding segment if it's nonempty
-          (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, std::string(i, p));
+          (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, std::string(i, p));
         }
         // we need to skip anything inside strings
         // create a new target in parser/prelexer
@@ -1484,7 +1551,7 @@ namespace Sass {
         const char* j = skip_over_scopes< exactly<hash_lbrace>, exactly<rbrace> >(p + 2, chunk.end); // find the closing brace
         if (j) { --j;
           // parse the interpolant and accumulate it
-          Expression* interp_node = Parser::from_token(Token(p+2, j), ctx, pstate, source).parse_list();
+          Expression* interp_node = Parser::from_token(Token(p+2, j), ctx, mem, pstate, source).parse_list();
           interp_node->is_interpolant(true);
           (*schema) << interp_node;
           i = j;
@@ -1496,7 +1563,7 @@ namespace Sass {
       }
       else { // no interpolants left; add the last segment if nonempty
         // check if we need quotes here (was not sure after merge)
-        if (i < chunk.end) (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, std::string(i, chunk.end));
+        if (i < chunk.end) (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, std::string(i, chunk.end));
         break;
       }
       ++ i;
@@ -1520,7 +1587,7 @@ namespace Sass {
     --str.end;
     --position;
 
-    String_Constant* str_node = SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, str.time_wspace());
+    String_Constant* str_node = SASS_MEMORY_NEW(mem, String_Constant, pstate, str.time_wspace());
     return str_node;
   }
 
@@ -1537,15 +1604,15 @@ namespace Sass {
     // see if there any interpolants
     const char* p = find_first_in_interval< exactly<hash_lbrace>, block_comment >(str.begin, str.end);
     if (!p) {
-      return SASS_MEMORY_NEW(ctx.mem, String_Quoted, pstate, std::string(str.begin, str.end));
+      return SASS_MEMORY_NEW(mem, String_Quoted, pstate, std::string(str.begin, str.end));
     }
 
-    String_Schema* schema = SASS_MEMORY_NEW(ctx.mem, String_Schema, pstate);
+    String_Schema* schema = SASS_MEMORY_NEW(mem, String_Schema, pstate);
     while (i < str.end) {
       p = find_first_in_interval< exactly<hash_lbrace>, block_comment >(i, str.end);
       if (p) {
         if (i < p) {
-          (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, std::string(i, p)); // accumulate the preceding segment if it's nonempty
+          (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, std::string(i, p)); // accumulate the preceding segment if it's nonempty
         }
         if (peek < sequence < optional_spaces, exactly<rbrace> > >(p+2)) { position = p+2;
           css_error("Invalid CSS", " after ", ": expected expression (e.g. 1px, bold), was ");
@@ -1553,7 +1620,7 @@ namespace Sass {
         const char* j = skip_over_scopes< exactly<hash_lbrace>, exactly<rbrace> >(p+2, str.end); // find the closing brace
         if (j) {
           // parse the interpolant and accumulate it
-          Expression* interp_node = Parser::from_token(Token(p+2, j), ctx, pstate, source).parse_list();
+          Expression* interp_node = Parser::from_token(Token(p+2, j), ctx, mem, pstate, source).parse_list();
           interp_node->is_interpolant(true);
           (*schema) << interp_node;
           i = j;
@@ -1565,7 +1632,7 @@ namespace Sass {
       }
       else { // no interpolants left; add the last segment if nonempty
         if (i < str.end) {
-          (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, std::string(i, str.end));
+          (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, std::string(i, str.end));
         }
         break;
       }
@@ -1575,17 +1642,17 @@ namespace Sass {
 
   String* Parser::parse_ie_keyword_arg()
   {
-    String_Schema* kwd_arg = SASS_MEMORY_NEW(ctx.mem, String_Schema, pstate, 3);
+    String_Schema* kwd_arg = SASS_MEMORY_NEW(mem, String_Schema, pstate, 3);
     if (lex< variable >()) {
-      *kwd_arg << SASS_MEMORY_NEW(ctx.mem, Variable, pstate, Util::normalize_underscores(lexed));
+      *kwd_arg << SASS_MEMORY_NEW(mem, Variable, pstate, Util::normalize_underscores(lexed));
     } else {
       lex< alternatives< identifier_schema, identifier > >();
-      *kwd_arg << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+      *kwd_arg << SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
     }
     lex< exactly<'='> >();
-    *kwd_arg << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+    *kwd_arg << SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
     if (peek< variable >()) *kwd_arg << parse_list();
-    else if (lex< number >()) *kwd_arg << SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::NUMBER, Util::normalize_decimals(lexed));
+    else if (lex< number >()) *kwd_arg << SASS_MEMORY_NEW(mem, Textual, pstate, Textual::NUMBER, Util::normalize_decimals(lexed));
     else if (peek < ie_keyword_arg_value >()) { *kwd_arg << parse_list(); }
     return kwd_arg;
   }
@@ -1593,7 +1660,7 @@ namespace Sass {
   String_Schema* Parser::parse_value_schema(const char* stop)
   {
     // initialize the string schema object to add tokens
-    String_Schema* schema = SASS_MEMORY_NEW(ctx.mem, String_Schema, pstate);
+    String_Schema* schema = SASS_MEMORY_NEW(mem, String_Schema, pstate);
 
     if (peek<exactly<'}'>>()) {
       css_error("Invalid CSS", " after ", ": expected expression (e.g. 1px, bold), was ");
@@ -1611,7 +1678,7 @@ namespace Sass {
       }
       if (need_space) {
         need_space = false;
-        // (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, " ");
+        // (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, " ");
       }
       if ((e = peek< re_functional >()) && e < stop) {
         (*schema) << parse_function_call();
@@ -1624,7 +1691,7 @@ namespace Sass {
         }
         Expression* ex = 0;
         if (lex< re_static_expression >()) {
-          ex = SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+          ex = SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
         } else {
           ex = parse_list();
         }
@@ -1636,12 +1703,12 @@ namespace Sass {
       // lex some string constants or other valid token
       // Note: [-+] chars are left over from i.e. `#{3}+3`
       else if (lex< alternatives < exactly<'%'>, exactly < '-' >, exactly < '+' > > >()) {
-        (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+        (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
       }
       // lex a quoted string
       else if (lex< quoted_string >()) {
         // need_space = true;
-        // if (schema->length()) (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, " ");
+        // if (schema->length()) (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, " ");
         // else need_space = true;
         (*schema) << parse_string();
         if ((*position == '"' || *position == '\'') || peek < alternatives < alpha > >()) {
@@ -1650,7 +1717,7 @@ namespace Sass {
         if (peek < exactly < '-' > >()) break;
       }
       else if (lex< sequence < identifier > >()) {
-        (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+        (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
         if ((*position == '"' || *position == '\'') || peek < alternatives < alpha > >()) {
            // need_space = true;
         }
@@ -1658,26 +1725,26 @@ namespace Sass {
       // lex (normalized) variable
       else if (lex< variable >()) {
         std::string name(Util::normalize_underscores(lexed));
-        (*schema) << SASS_MEMORY_NEW(ctx.mem, Variable, pstate, name);
+        (*schema) << SASS_MEMORY_NEW(mem, Variable, pstate, name);
       }
       // lex percentage value
       else if (lex< percentage >()) {
-        (*schema) << SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::PERCENTAGE, lexed);
+        (*schema) << SASS_MEMORY_NEW(mem, Textual, pstate, Textual::PERCENTAGE, lexed);
       }
       // lex dimension value
       else if (lex< dimension >()) {
-        (*schema) << SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::DIMENSION, lexed);
+        (*schema) << SASS_MEMORY_NEW(mem, Textual, pstate, Textual::DIMENSION, lexed);
       }
       // lex number value
       else if (lex< number >()) {
-        (*schema) <<  SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::NUMBER, lexed);
+        (*schema) <<  SASS_MEMORY_NEW(mem, Textual, pstate, Textual::NUMBER, lexed);
       }
       // lex hex color value
       else if (lex< sequence < hex, negate < exactly < '-' > > > >()) {
-        (*schema) << SASS_MEMORY_NEW(ctx.mem, Textual, pstate, Textual::HEX, lexed);
+        (*schema) << SASS_MEMORY_NEW(mem, Textual, pstate, Textual::HEX, lexed);
       }
       else if (lex< sequence < exactly <'#'>, identifier > >()) {
-        (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Quoted, pstate, lexed);
+        (*schema) << SASS_MEMORY_NEW(mem, String_Quoted, pstate, lexed);
       }
       // lex a value in parentheses
       else if (peek< parenthese_scope >()) {
@@ -1689,7 +1756,7 @@ namespace Sass {
       ++num_items;
     }
     if (position != stop) {
-      (*schema) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, std::string(position, stop));
+      (*schema) << SASS_MEMORY_NEW(mem, String_Constant, pstate, std::string(position, stop));
       position = stop;
     }
     end = ee;
@@ -1705,10 +1772,10 @@ namespace Sass {
     // see if there any interpolants
     const char* p = find_first_in_interval< exactly<hash_lbrace>, block_comment >(id.begin, id.end);
     if (!p) {
-      return SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, std::string(id.begin, id.end));
+      return SASS_MEMORY_NEW(mem, String_Constant, pstate, std::string(id.begin, id.end));
     }
 
-    String_Schema* schema = SASS_MEMORY_NEW(ctx.mem, String_Schema, pstate);
+    String_Schema* schema = SASS_MEMORY_NEW(mem, String_Schema, pstate);
     while (i < id.end) {
       p = find_first_in_interval< exactly<hash_lbrace>, block_comment >(i, id.end);
       if (p) {
@@ -1726,7 +1793,7 @@ namespace Sass {
         const char* j = skip_over_scopes< exactly<hash_lbrace>, exactly<rbrace> >(p+2, id.end); // find the closing brace
         if (j) {
           // parse the interpolant and accumulate it
-          Expression* interp_node = Parser::from_token(Token(p+2, j), ctx, pstate, source).parse_list(DELAYED);
+          Expression* interp_node = Parser::from_token(Token(p+2, j), ctx, mem, pstate, source).parse_list(DELAYED);
           interp_node->is_interpolant(true);
           (*schema) << interp_node;
           // schema->has_interpolants(true);
@@ -1765,10 +1832,10 @@ namespace Sass {
           exactly < ')' >
         > >();
 
-    Argument* arg = SASS_MEMORY_NEW(ctx.mem, Argument, arg_pos, parse_interpolated_chunk(Token(arg_beg, arg_end)));
-    Arguments* args = SASS_MEMORY_NEW(ctx.mem, Arguments, arg_pos);
+    Argument* arg = SASS_MEMORY_NEW(mem, Argument, arg_pos, parse_interpolated_chunk(Token(arg_beg, arg_end)));
+    Arguments* args = SASS_MEMORY_NEW(mem, Arguments, arg_pos);
     *args << arg;
-    return SASS_MEMORY_NEW(ctx.mem, Function_Call, call_pos, name, args);
+    return SASS_MEMORY_NEW(mem, Function_Call, call_pos, name, args);
   }
 
   String* Parser::parse_url_function_string()
@@ -1792,14 +1859,14 @@ namespace Sass {
     }
 
     if (String_Schema* schema = dynamic_cast<String_Schema*>(url_string)) {
-      String_Schema* res = SASS_MEMORY_NEW(ctx.mem, String_Schema, pstate);
-      (*res) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, prefix);
+      String_Schema* res = SASS_MEMORY_NEW(mem, String_Schema, pstate);
+      (*res) << SASS_MEMORY_NEW(mem, String_Constant, pstate, prefix);
       (*res) += schema;
-      (*res) << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, suffix);
+      (*res) << SASS_MEMORY_NEW(mem, String_Constant, pstate, suffix);
       return res;
     } else {
       std::string res = prefix + uri + suffix;
-      return SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, res);
+      return SASS_MEMORY_NEW(mem, String_Constant, pstate, res);
     }
   }
 
@@ -1823,7 +1890,7 @@ namespace Sass {
     }
     else if (uri != "") {
       std::string res = Util::rtrim(uri);
-      return SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, res);
+      return SASS_MEMORY_NEW(mem, String_Constant, pstate, res);
     }
 
     return 0;
@@ -1836,7 +1903,7 @@ namespace Sass {
 
     ParserState call_pos = pstate;
     Arguments* args = parse_arguments();
-    return SASS_MEMORY_NEW(ctx.mem, Function_Call, call_pos, name, args);
+    return SASS_MEMORY_NEW(mem, Function_Call, call_pos, name, args);
   }
 
   Function_Call_Schema* Parser::parse_function_call_schema()
@@ -1844,13 +1911,13 @@ namespace Sass {
     String* name = parse_identifier_schema();
     ParserState source_position_of_call = pstate;
 
-    Function_Call_Schema* the_call = SASS_MEMORY_NEW(ctx.mem, Function_Call_Schema, source_position_of_call, name, parse_arguments());
+    Function_Call_Schema* the_call = SASS_MEMORY_NEW(mem, Function_Call_Schema, source_position_of_call, name, parse_arguments());
     return the_call;
   }
 
   Content* Parser::parse_content_directive()
   {
-    return SASS_MEMORY_NEW(ctx.mem, Content, pstate);
+    return SASS_MEMORY_NEW(mem, Content, pstate);
   }
 
   If* Parser::parse_if_directive(bool else_if)
@@ -1864,14 +1931,14 @@ namespace Sass {
     // only throw away comment if we parse a case
     // we want all other comments to be parsed
     if (lex_css< elseif_directive >()) {
-      alternative = SASS_MEMORY_NEW(ctx.mem, Block, pstate);
+      alternative = SASS_MEMORY_NEW(mem, Block, pstate);
       (*alternative) << parse_if_directive(true);
     }
     else if (lex_css< kwd_else_directive >()) {
       alternative = parse_block();
     }
     stack.pop_back();
-    return SASS_MEMORY_NEW(ctx.mem, If, if_source_position, predicate, block, alternative);
+    return SASS_MEMORY_NEW(mem, If, if_source_position, predicate, block, alternative);
   }
 
   For* Parser::parse_for_directive()
@@ -1889,7 +1956,7 @@ namespace Sass {
     Expression* upper_bound = parse_expression();
     Block* body = parse_block();
     stack.pop_back();
-    return SASS_MEMORY_NEW(ctx.mem, For, for_source_position, var, lower_bound, upper_bound, body, inclusive);
+    return SASS_MEMORY_NEW(mem, For, for_source_position, var, lower_bound, upper_bound, body, inclusive);
   }
 
   // helper to parse a var token
@@ -1933,7 +2000,7 @@ namespace Sass {
     Expression* list = parse_list();
     Block* body = parse_block();
     stack.pop_back();
-    return SASS_MEMORY_NEW(ctx.mem, Each, each_source_position, vars, list, body);
+    return SASS_MEMORY_NEW(mem, Each, each_source_position, vars, list, body);
   }
 
   // called after parsing `kwd_while_directive`
@@ -1941,7 +2008,7 @@ namespace Sass {
   {
     stack.push_back(Scope::Control);
     // create the initial while call object
-    While* call = SASS_MEMORY_NEW(ctx.mem, While, pstate, 0, 0);
+    While* call = SASS_MEMORY_NEW(mem, While, pstate, 0, 0);
     // parse mandatory predicate
     Expression* predicate = parse_list();
     call->predicate(predicate);
@@ -1957,7 +2024,7 @@ namespace Sass {
   Media_Block* Parser::parse_media_block()
   {
     stack.push_back(Scope::Media);
-    Media_Block* media_block = SASS_MEMORY_NEW(ctx.mem, Media_Block, pstate, 0, 0);
+    Media_Block* media_block = SASS_MEMORY_NEW(mem, Media_Block, pstate, 0, 0);
     media_block->media_queries(parse_media_queries());
 
     Media_Block* prev_media_block = last_media_block;
@@ -1970,7 +2037,7 @@ namespace Sass {
 
   List* Parser::parse_media_queries()
   {
-    List* media_queries = SASS_MEMORY_NEW(ctx.mem, List, pstate, 0, SASS_COMMA);
+    List* media_queries = SASS_MEMORY_NEW(mem, List, pstate, 0, SASS_COMMA);
     if (!peek_css < exactly <'{'> >()) (*media_queries) << parse_media_query();
     while (lex_css < exactly <','> >()) (*media_queries) << parse_media_query();
     return media_queries;
@@ -1979,7 +2046,7 @@ namespace Sass {
   // Expression* Parser::parse_media_query()
   Media_Query* Parser::parse_media_query()
   {
-    Media_Query* media_query = SASS_MEMORY_NEW(ctx.mem, Media_Query, pstate);
+    Media_Query* media_query = SASS_MEMORY_NEW(mem, Media_Query, pstate);
 
     lex < css_comments >(false);
     if (lex < kwd_not >()) media_query->is_negated(true);
@@ -1992,9 +2059,9 @@ namespace Sass {
 
     while (lex_css < kwd_and >()) (*media_query) << parse_media_expression();
     if (lex < identifier_schema >()) {
-      String_Schema* schema = SASS_MEMORY_NEW(ctx.mem, String_Schema, pstate);
+      String_Schema* schema = SASS_MEMORY_NEW(mem, String_Schema, pstate);
       *schema << media_query->media_type();
-      *schema << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, " ");
+      *schema << SASS_MEMORY_NEW(mem, String_Constant, pstate, " ");
       *schema << parse_identifier_schema();
       media_query->media_type(schema);
     }
@@ -2006,7 +2073,7 @@ namespace Sass {
   {
     if (lex < identifier_schema >()) {
       String* ss = parse_identifier_schema();
-      return SASS_MEMORY_NEW(ctx.mem, Media_Query_Expression, pstate, ss, 0, true);
+      return SASS_MEMORY_NEW(mem, Media_Query_Expression, pstate, ss, 0, true);
     }
     if (!lex_css< exactly<'('> >()) {
       error("media query expression must begin with '('", pstate);
@@ -2023,7 +2090,7 @@ namespace Sass {
     if (!lex_css< exactly<')'> >()) {
       error("unclosed parenthesis in media query expression", pstate);
     }
-    return SASS_MEMORY_NEW(ctx.mem, Media_Query_Expression, feature->pstate(), feature, expression);
+    return SASS_MEMORY_NEW(mem, Media_Query_Expression, feature->pstate(), feature, expression);
   }
 
   // lexed after `kwd_supports_directive`
@@ -2032,7 +2099,7 @@ namespace Sass {
   {
     Supports_Condition* cond = parse_supports_condition();
     // create the ast node object for the support queries
-    Supports_Block* query = SASS_MEMORY_NEW(ctx.mem, Supports_Block, pstate, cond);
+    Supports_Block* query = SASS_MEMORY_NEW(mem, Supports_Block, pstate, cond);
     // additional block is mandatory
     // parse inner block
     query->block(parse_block());
@@ -2056,7 +2123,7 @@ namespace Sass {
     if (!lex < kwd_not >()) return 0;
 
     Supports_Condition* cond = parse_supports_condition_in_parens();
-    return SASS_MEMORY_NEW(ctx.mem, Supports_Negation, pstate, cond);
+    return SASS_MEMORY_NEW(mem, Supports_Negation, pstate, cond);
   }
 
   Supports_Condition* Parser::parse_supports_operator()
@@ -2072,8 +2139,8 @@ namespace Sass {
       lex < css_whitespace >();
       Supports_Condition* right = parse_supports_condition_in_parens();
 
-      // Supports_Condition* cc = SASS_MEMORY_NEW(ctx.mem, Supports_Condition, *static_cast<Supports_Condition*>(cond));
-      cond = SASS_MEMORY_NEW(ctx.mem, Supports_Operator, pstate, cond, right, op);
+      // Supports_Condition* cc = SASS_MEMORY_NEW(mem, Supports_Condition, *static_cast<Supports_Condition*>(cond));
+      cond = SASS_MEMORY_NEW(mem, Supports_Operator, pstate, cond, right, op);
     }
     return cond;
   }
@@ -2085,7 +2152,7 @@ namespace Sass {
     String* interp = parse_interpolated_chunk(lexed);
     if (!interp) return 0;
 
-    return SASS_MEMORY_NEW(ctx.mem, Supports_Interpolation, pstate, interp);
+    return SASS_MEMORY_NEW(mem, Supports_Interpolation, pstate, interp);
   }
 
   // TODO: This needs some major work. Although feature conditions
@@ -2096,7 +2163,7 @@ namespace Sass {
     // parse something declaration like
     Declaration* declaration = parse_declaration();
     if (!declaration) error("@supports condition expected declaration", pstate);
-    cond = SASS_MEMORY_NEW(ctx.mem, Supports_Declaration,
+    cond = SASS_MEMORY_NEW(mem, Supports_Declaration,
                      declaration->pstate(),
                      declaration->property(),
                      declaration->value());
@@ -2139,10 +2206,10 @@ namespace Sass {
     }
     else if ((lookahead_result = lookahead_for_selector(position)).found) {
       Ruleset* r = parse_ruleset(lookahead_result, false);
-      body = SASS_MEMORY_NEW(ctx.mem, Block, r->pstate(), 1, true);
+      body = SASS_MEMORY_NEW(mem, Block, r->pstate(), 1, true);
       *body << r;
     }
-    At_Root_Block* at_root = SASS_MEMORY_NEW(ctx.mem, At_Root_Block, at_source_position, body);
+    At_Root_Block* at_root = SASS_MEMORY_NEW(mem, At_Root_Block, at_source_position, body);
     if (expr) at_root->expression(expr);
     return at_root;
   }
@@ -2158,14 +2225,14 @@ namespace Sass {
     Expression* feature = parse_list();
     if (!lex_css< exactly<':'> >()) error("style declaration must contain a value", pstate);
     Expression* expression = parse_list();
-    List* value = SASS_MEMORY_NEW(ctx.mem, List, feature->pstate(), 1);
+    List* value = SASS_MEMORY_NEW(mem, List, feature->pstate(), 1);
 
     if (expression->concrete_type() == Expression::LIST) {
         value = static_cast<List*>(expression);
     }
     else *value << expression;
 
-    At_Root_Query* cond = SASS_MEMORY_NEW(ctx.mem, At_Root_Query,
+    At_Root_Query* cond = SASS_MEMORY_NEW(mem, At_Root_Query,
                                           value->pstate(),
                                           feature,
                                           value);
@@ -2179,7 +2246,7 @@ namespace Sass {
 
     if (lexed == "@else") error("Invalid CSS: @else must come after @if", pstate);
 
-    Directive* at_rule = SASS_MEMORY_NEW(ctx.mem, Directive, pstate, kwd);
+    Directive* at_rule = SASS_MEMORY_NEW(mem, Directive, pstate, kwd);
     Lookahead lookahead = lookahead_for_include(position);
     if (lookahead.found && !lookahead.has_interpolants) {
       at_rule->selector(parse_selector_list(true));
@@ -2208,7 +2275,7 @@ namespace Sass {
 
     if (lexed == "@else") error("Invalid CSS: @else must come after @if", pstate);
 
-    Directive* at_rule = SASS_MEMORY_NEW(ctx.mem, Directive, pstate, kwd);
+    Directive* at_rule = SASS_MEMORY_NEW(mem, Directive, pstate, kwd);
     Lookahead lookahead = lookahead_for_include(position);
     if (lookahead.found && !lookahead.has_interpolants) {
       at_rule->selector(parse_selector_list(true));
@@ -2234,7 +2301,7 @@ namespace Sass {
 
   Directive* Parser::parse_directive()
   {
-    Directive* directive = SASS_MEMORY_NEW(ctx.mem, Directive, pstate, lexed);
+    Directive* directive = SASS_MEMORY_NEW(mem, Directive, pstate, lexed);
     Expression* val = parse_almost_any_value();
     // strip left and right if they are of type string
     directive->value(val);
@@ -2316,7 +2383,7 @@ namespace Sass {
     >(false);
     if (match) {
       // std::cerr << "[[" << std::string(lexed) << "]\n";
-      return SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+      return SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
     }
     return NULL;
   }
@@ -2337,7 +2404,7 @@ namespace Sass {
   String_Schema* Parser::parse_almost_any_value()
   {
 
-    String_Schema* schema = SASS_MEMORY_NEW(ctx.mem, String_Schema, pstate);
+    String_Schema* schema = SASS_MEMORY_NEW(mem, String_Schema, pstate);
     if (*position == 0) return 0;
     lex < spaces >(false);
     Expression* token = lex_almost_any_value_token();
@@ -2369,7 +2436,7 @@ namespace Sass {
         stack.back() != Scope::Rules) {
       error("Illegal nesting: Only properties may be nested beneath properties.", pstate);
     }
-    return SASS_MEMORY_NEW(ctx.mem, Warning, pstate, parse_list(DELAYED));
+    return SASS_MEMORY_NEW(mem, Warning, pstate, parse_list(DELAYED));
   }
 
   Error* Parser::parse_error()
@@ -2381,7 +2448,7 @@ namespace Sass {
         stack.back() != Scope::Rules) {
       error("Illegal nesting: Only properties may be nested beneath properties.", pstate);
     }
-    return SASS_MEMORY_NEW(ctx.mem, Error, pstate, parse_list(DELAYED));
+    return SASS_MEMORY_NEW(mem, Error, pstate, parse_list(DELAYED));
   }
 
   Debug* Parser::parse_debug()
@@ -2393,7 +2460,7 @@ namespace Sass {
         stack.back() != Scope::Rules) {
       error("Illegal nesting: Only properties may be nested beneath properties.", pstate);
     }
-    return SASS_MEMORY_NEW(ctx.mem, Debug, pstate, parse_list(DELAYED));
+    return SASS_MEMORY_NEW(mem, Debug, pstate, parse_list(DELAYED));
   }
 
   Return* Parser::parse_return_directive()
@@ -2401,7 +2468,7 @@ namespace Sass {
     // check that we do not have an empty list (ToDo: check if we got all cases)
     if (peek_css < alternatives < exactly < ';' >, exactly < '}' >, end_of_file > >())
     { css_error("Invalid CSS", " after ", ": expected expression (e.g. 1px, bold), was "); }
-    return SASS_MEMORY_NEW(ctx.mem, Return, pstate, parse_list());
+    return SASS_MEMORY_NEW(mem, Return, pstate, parse_list());
   }
 
   Lookahead Parser::lookahead_for_selector(const char* start)
@@ -2410,6 +2477,17 @@ namespace Sass {
     Lookahead rv = Lookahead();
     // get start position
     const char* p = start ? start : position;
+    // plain selectors and declarations are the common case, they
+    // need no interpolation check or the full selector match
+    if (const char* q = peek < re_simple_selector_list >(p)) {
+      if (q < end && std::strchr("{:;}", *q)) {
+        rv.position = q;
+        if (*q == '{') rv.found = q;
+        else rv.error = q;
+        rv.parsable = true;
+        return rv;
+      }
+    }
     // match in one big "regex"
     rv.error = p;
     if (const char* q =
@@ -2606,7 +2684,7 @@ namespace Sass {
   Expression* Parser::fold_operands(Expression* base, std::vector<Expression*>& operands, Operand op)
   {
     for (size_t i = 0, S = operands.size(); i < S; ++i) {
-      base = SASS_MEMORY_NEW(ctx.mem, Binary_Expression, pstate, op, base, operands[i]);
+      base = SASS_MEMORY_NEW(mem, Binary_Expression, pstate, op, base, operands[i]);
     }
     return base;
   }
@@ -2628,7 +2706,7 @@ namespace Sass {
           || (ops[0].operand == Sass_OP::GTE)
         )) {
           Expression* rhs = fold_operands(operands[0], operands, ops, 1);
-          rhs = SASS_MEMORY_NEW(ctx.mem, Binary_Expression, base->pstate(), ops[0], schema, rhs);
+          rhs = SASS_MEMORY_NEW(mem, Binary_Expression, base->pstate(), ops[0], schema, rhs);
           return rhs;
         }
         // return schema;
@@ -2640,17 +2718,17 @@ namespace Sass {
         if (schema->has_interpolants()) {
           if (i + 1 < S) {
             Expression* rhs = fold_operands(operands[i+1], operands, ops, i + 2);
-            rhs = SASS_MEMORY_NEW(ctx.mem, Binary_Expression, base->pstate(), ops[i], schema, rhs);
-            base = SASS_MEMORY_NEW(ctx.mem, Binary_Expression, base->pstate(), ops[i], base, rhs);
+            rhs = SASS_MEMORY_NEW(mem, Binary_Expression, base->pstate(), ops[i], schema, rhs);
+            base = SASS_MEMORY_NEW(mem, Binary_Expression, base->pstate(), ops[i], base, rhs);
             return base;
           }
-          base = SASS_MEMORY_NEW(ctx.mem, Binary_Expression, base->pstate(), ops[i], base, operands[i]);
+          base = SASS_MEMORY_NEW(mem, Binary_Expression, base->pstate(), ops[i], base, operands[i]);
           return base;
         } else {
-          base = SASS_MEMORY_NEW(ctx.mem, Binary_Expression, base->pstate(), ops[i], base, operands[i]);
+          base = SASS_MEMORY_NEW(mem, Binary_Expression, base->pstate(), ops[i], base, operands[i]);
         }
       } else {
-        base = SASS_MEMORY_NEW(ctx.mem, Binary_Expression, base->pstate(), ops[i], base, operands[i]);
+        base = SASS_MEMORY_NEW(mem, Binary_Expression, base->pstate(), ops[i], base, operands[i]);
       }
       Binary_Expression* b = static_cast<Binary_Expression*>(base);
       if (b && ops[i].operand == Sass_OP::DIV && b->left()->is_delayed() && b->right()->is_delayed()) {
@@ -26,6 +26,8 @@ namespace Sass {
     enum Scope { Root, Mixin, Function, Media, Control, Properties, Rules };
 
     Context& ctx;
+    // nodes are allocated here
+    Memory_Manager& mem;
     std::vector<Block*> block_stack;
     std::vector<Scope> stack;
     Media_Block* last_media_block;
@@ -36,20 +38,26 @@ namespace Sass {
     Position after_token;
     ParserState pstate;
     int indentation;
+    // linefeeds of the source (optional)
+    Line_Index* lines;
 
 
     Token lexed;
     bool in_at_root;
 
-    Parser(Context& ctx, const ParserState& pstate)
-    : ParserState(pstate), ctx(ctx), block_stack(0), stack(0), last_media_block(0),
-      source(0), position(0), end(0), before_token(pstate), after_token(pstate), pstate(pstate), indentation(0)
+    Parser(Context& ctx, Memory_Manager& mem, const ParserState& pstate)
+    : ParserState(pstate), ctx(ctx), mem(mem), block_stack(0), stack(0), last_media_block(0),
+      source(0), position(0), end(0), before_token(pstate), after_token(pstate), pstate(pstate), indentation(0), lines(0)
     { in_at_root = false; stack.push_back(Scope::Root); }
 
     // static Parser from_string(const std::string& src, Context& ctx, ParserState pstate = ParserState("[STRING]"));
     static Parser from_c_str(const char* src, Context& ctx, ParserState pstate = ParserState("[CSTRING]"), const char* source = 0);
     static Parser from_c_str(const char* beg, const char* end, Context& ctx, ParserState pstate = ParserState("[CSTRING]"), const char* source = 0);
     static Parser from_token(Token t, Context& ctx, ParserState pstate = ParserState("[TOKEN]"), const char* source = 0);
+    // same as above, but nodes are allocated on the given memory
+    static Parser from_c_str(const char* src, Context& ctx, Memory_Manager& mem, ParserState pstate, const char* source = 0);
+    static Parser from_c_str(const char* beg, const char* end, Context& ctx, Memory_Manager& mem, ParserState pstate, const char* source = 0);
+    static Parser from_token(Token t, Context& ctx, Memory_Manager& mem, ParserState pstate, const char* source = 0);
     // special static parsers to convert strings into certain selectors
     static CommaSequence_Selector* parse_selector(const char* src, Context& ctx, ParserState pstate = ParserState("[SELECTOR]"), const char* source = 0);
 
@@ -68,6 +76,14 @@ namespace Sass {
 
     bool peek_newline(const char* start = 0);
 
+    // move source position over the given text
+    Position& advance(Position& pos, const char* begin, const char* end)
+    {
+      if (lines) lines->add(pos, begin, end);
+      else pos.add(begin, end);
+      return pos;
+    }
+
     // skip over spaces, tabs and line comments
     template <Prelexer::prelexer mx>
     const char* sneak(const char* start = 0)
@@ -162,10 +178,10 @@ namespace Sass {
       lexed = Token(position, it_before_token, it_after_token);
 
       // advance position (add whitespace before current token)
-      before_token = after_token.add(position, it_before_token);
+      before_token = advance(after_token, position, it_before_token);
 
       // update after_token position for current token
-      after_token.add(it_before_token, it_after_token);
+      advance(after_token, it_before_token, it_after_token);
 
       // ToDo: could probably do this incremetal on original object (API wants offset?)
       pstate = ParserState(path, source, lexed, before_token, after_token - before_token);
@@ -336,15 +352,15 @@ namespace Sass {
     Expression* lex_interp()
     {
       if (lex < open >(false)) {
-        String_Schema* schema = SASS_MEMORY_NEW(ctx.mem, String_Schema, pstate);
+        String_Schema* schema = SASS_MEMORY_NEW(mem, String_Schema, pstate);
         // std::cerr << "LEX [[" << std::string(lexed) << "]]\n";
-        *schema << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+        *schema << SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
         if (position[0] == '#' && position[1] == '{') {
           Expression* itpl = lex_interpolation();
           if (itpl) *schema << itpl;
           while (lex < close >(false)) {
             // std::cerr << "LEX [[" << std::string(lexed) << "]]\n";
-            *schema << SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+            *schema << SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
             if (position[0] == '#' && position[1] == '{') {
               Expression* itpl = lex_interpolation();
               if (itpl) *schema << itpl;
@@ -353,7 +369,7 @@ namespace Sass {
             }
           }
         } else {
-          return SASS_MEMORY_NEW(ctx.mem, String_Constant, pstate, lexed);
+          return SASS_MEMORY_NEW(mem, String_Constant, pstate, lexed);
         }
       }
       return 0;
@@ -83,6 +83,36 @@ namespace Sass {
     return Offset(line - off.line, off.line == line ? column - off.column : column);
   }
 
+  Line_Index::Line_Index(const char* begin, const char* end)
+  : linefeeds(), cursor(0)
+  {
+    while (begin < end) {
+      begin = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+      if (begin == 0) break;
+      linefeeds.push_back(begin ++);
+    }
+  }
+
+  void Line_Index::add(Offset& offset, const char* begin, const char* end)
+  {
+    if (begin >= end) return;
+    size_t size = linefeeds.size();
+    // move to the first linefeed in the part
+    while (cursor > 0 && linefeeds[cursor - 1] >= begin) -- cursor;
+    while (cursor < size && linefeeds[cursor] < begin) ++ cursor;
+    // count all linefeeds in the part
+    size_t last = cursor;
+    while (last < size && linefeeds[last] < end) ++ last;
+    if (last == cursor) {
+      offset.column += end - begin;
+    } else {
+      offset.line += last - cursor;
+      // count columns on the last line
+      offset.column = end - linefeeds[last - 1] - 1;
+    }
+    cursor = last;
+  }
+
   Position::Position(const size_t file)
   : Offset(0, 0), file(file) { }
 
@@ -2,6 +2,7 @@
 #define SASS_POSITION_H
 
 #include <string>
+#include <vector>
 #include <cstring>
 // #include <iostream>
 
@@ -67,6 +68,25 @@ namespace Sass {
 
   };
 
+  // Linefeeds of a source, found once with memchr. Advances offsets
+  // over parts of the source like Offset::add, without visiting every
+  // character. Moves are expected to be mostly forward (like a lexer).
+  class Line_Index {
+
+    public: // c-tor
+      Line_Index(const char* begin, const char* end);
+
+    public:
+      // same as offset.add(begin, end) for parts of the source
+      void add(Offset& offset, const char* begin, const char* end);
+
+    private:
+      std::vector<const char*> linefeeds;
+      // first linefeed after the last added part
+      size_t cursor;
+
+  };
+
   // Token type for representing lexed chunks of text
   class Token {
   public:
@@ -1,6 +1,7 @@
 #include "sass.hpp"
 #include <cctype>
 #include <cstddef>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include "util.hpp"
@@ -261,15 +262,8 @@ namespace Sass {
     // Match a line comment (/.*?(?=\n|\r\n?|\Z)/.
     const char* line_comment(const char* src)
     {
-      return sequence<
-               exactly <
-                 slash_slash
-               >,
-               non_greedy<
-                 any_char,
-                 end_of_line
-               >
-             >(src);
+      src = exactly < slash_slash >(src);
+      return src ? scan_chars(src, '\n', '\r', '\r') : 0;
     }
 
     // Match a block comment.
@@ -501,6 +495,15 @@ namespace Sass {
       return recursive_scopes< exactly<hash_lbrace>, exactly<rbrace> >(src);
     }
 
+    // one or more chars of a quoted string that can not start an
+    // escape or interpolant, or close it; none of the alternatives
+    // below consume one of those, so we can skip them in one go
+    template <char quote>
+    const char* any_chars_but_special(const char* src) {
+      const char* p = scan_chars(src, quote, '\\', '#');
+      return p == src ? 0 : p;
+    }
+
     // $re_squote = /'(?:$re_itplnt|\\.|[^'])*'/
     const char* single_quoted_string(const char* src) {
       // match a single quoted string, while skipping interpolants
@@ -508,6 +511,8 @@ namespace Sass {
         exactly <'\''>,
         zero_plus <
           alternatives <
+            // skip plain chars
+            any_chars_but_special < '\'' >,
             // skip escapes
             sequence <
               exactly < '\\' >,
@@ -532,6 +537,8 @@ namespace Sass {
         exactly <'"'>,
         zero_plus <
           alternatives <
+            // skip plain chars
+            any_chars_but_special < '"' >,
             // skip escapes
             sequence <
               exactly < '\\' >,
@@ -1629,6 +1636,38 @@ namespace Sass {
       >(src);
     }
 
+    // Match a plain selector list: names, classes, ids, placeholders,
+    // parent references, pseudo names and combinators. Also stops at a
+    // colon followed by white-space (a declaration). If it stops at `{`,
+    // `;`, `}` or such a colon, re_selector_list stops there as well.
+    // Lets the parser skip the full selector prelexer for common rules.
+    const char* re_simple_selector_list(const char* src) {
+      const char* p = src;
+      // a leading `&-` may be a partial bem selector
+      if (p[0] == '&' && p[1] == '-') {
+        const char* q = p + 1;
+        while (*q == '-') ++ q;
+        if (!is_alnum(*q)) return 0;
+      }
+      while (*p) {
+        if (is_space(*p) || std::strchr(",>+~*&%", *p)) { ++ p; continue; }
+        if (*p == '.' || *p == '#') ++ p;
+        else if (*p == ':') {
+          if (is_space(p[1])) break;
+          p += p[1] == ':' ? 2 : 1;
+        }
+        else if (!is_alnum(*p) && *p != '-' && *p != '_') break;
+        // names need more than hyphens
+        bool named = false;
+        while (is_alnum(*p) || *p == '-' || *p == '_') {
+          named = named || *p != '-';
+          ++ p;
+        }
+        if (!named) return 0;
+      }
+      return p == src ? 0 : p;
+    }
+
     const char* type_selector(const char* src) {
       return sequence< optional<namespace_schema>, identifier>(src);
     }
@@ -3,6 +3,7 @@
 
 #include <cstring>
 #include "lexer.hpp"
+#include "char_scan.hpp"
 
 namespace Sass {
   // using namespace Lexer;
@@ -46,7 +47,12 @@ namespace Sass {
       src = exactly<beg>(src);
       if (!src) return 0;
       const char* stop;
+      // the scalar scan is slower than this loop
+      // when the end char shows up often
+      const bool scan = char_scan_impl() != SCAN_SCALAR;
       while (1) {
+        // nothing before the next end char can stop
+        if (scan) src = scan_chars(src, end, end, end);
         if (!*src) return 0;
         stop = exactly<end>(src);
         if (stop && (!esc || *(src - 1) != '\\')) return stop;
@@ -83,6 +89,10 @@ namespace Sass {
         }
         else if (in_dquote || in_squote) {
           // take everything literally
+          // up to the next quote or escape
+          const char* next = scan_chars(src + 1, '\\', '"', '\'');
+          if (end && next > end) next = end;
+          src = next - 1;
         }
 
         // find another opener inside?
@@ -139,7 +149,12 @@ namespace Sass {
       src = exactly<beg>(src);
       if (!src) return 0;
       const char* stop;
+      // the scalar scan is slower than this loop
+      // when the first char of end shows up often
+      const bool scan = char_scan_impl() != SCAN_SCALAR;
       while (1) {
+        // nothing before the next first char of end can stop
+        if (scan) src = scan_chars(src, *end, *end, *end);
         if (!*src) return 0;
         stop = exactly<end>(src);
         if (stop && (!esc || *(src - 1) != '\\')) return stop;
@@ -275,6 +290,7 @@ namespace Sass {
     const char* kwd_null(const char* src);
 
     const char* re_selector_list(const char* src);
+    const char* re_simple_selector_list(const char* src);
     const char* re_type_selector(const char* src);
     const char* re_static_expression(const char* src);
 
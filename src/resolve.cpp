@@ -0,0 +1,237 @@
+#include "sass.hpp"
+#include <vector>
+
+#include "resolve.hpp"
+
+namespace Sass {
+
+  Resolve::Resolve()
+  : scopes()
+  { }
+
+  int Resolve::lookup(Symbol symbol)
+  {
+    // search from the innermost frame outwards
+    for (size_t i = scopes.size(); i > 0; --i) {
+      const std::vector<Symbol>& names = scopes[i - 1];
+      for (size_t n = 0, L = names.size(); n < L; ++n) {
+        if (names[n] == symbol) return int(scopes.size() - i);
+      }
+    }
+    return -1;
+  }
+
+  void Resolve::visit_scope(Block* b, const std::vector<Symbol>& names)
+  {
+    scopes.push_back(names);
+    if (b) b->perform(this);
+    scopes.pop_back();
+  }
+
+  void Resolve::visit_expression(Expression* ex)
+  {
+    // only bind variables inside function bodies
+    if (ex && !scopes.empty()) ex->perform(this);
+  }
+
+  void Resolve::operator()(Block* b)
+  {
+    for (size_t i = 0, L = b->length(); i < L; ++i) {
+      (*b)[i]->perform(this);
+    }
+  }
+
+  void Resolve::operator()(Ruleset* r)
+  {
+    if (r->block()) r->block()->perform(this);
+  }
+
+  void Resolve::operator()(Media_Block* m)
+  {
+    if (m->block()) m->block()->perform(this);
+  }
+
+  void Resolve::operator()(Supports_Block* s)
+  {
+    if (s->block()) s->block()->perform(this);
+  }
+
+  void Resolve::operator()(At_Root_Block* a)
+  {
+    if (a->block()) a->block()->perform(this);
+  }
+
+  void Resolve::operator()(Directive* d)
+  {
+    if (d->block()) d->block()->perform(this);
+  }
+
+  void Resolve::operator()(Definition* d)
+  {
+    Block* body = d->block();
+    if (!body) return;
+    // mixins are expanded with dynamic frames
+    if (d->type() != Definition::FUNCTION) {
+      return body->perform(this);
+    }
+    // parameters live in the frame of the call
+    // default values are evaluated while binding
+    // so we keep them on the dynamic lookup
+    std::vector<Symbol> names;
+    if (Parameters* params = d->parameters()) {
+      for (size_t i = 0, L = params->length(); i < L; ++i) {
+        names.push_back((*params)[i]->symbol());
+      }
+    }
+    visit_scope(body, names);
+  }
+
+  void Resolve::operator()(Assignment* a)
+  {
+    visit_expression(a->value());
+    if (scopes.empty()) return;
+    // only plain assignments update the lexical frame
+    if (a->is_global() || a->is_default()) return;
+    a->depth(lookup(a->symbol()));
+  }
+
+  void Resolve::operator()(Return* r)
+  {
+    visit_expression(r->value());
+  }
+
+  void Resolve::operator()(Warning* w)
+  {
+    visit_expression(w->message());
+  }
+
+  void Resolve::operator()(Error* e)
+  {
+    visit_expression(e->message());
+  }
+
+  void Resolve::operator()(Debug* d)
+  {
+    visit_expression(d->value());
+  }
+
+  void Resolve::operator()(If* i)
+  {
+    if (scopes.empty()) {
+      if (i->block()) i->block()->perform(this);
+      if (i->alternative()) i->alternative()->perform(this);
+      return;
+    }
+    // predicate is evaluated in the new frame
+    // the alternative shares the same frame
+    scopes.push_back(std::vector<Symbol>());
+    visit_expression(i->predicate());
+    if (i->block()) i->block()->perform(this);
+    if (i->alternative()) i->alternative()->perform(this);
+    scopes.pop_back();
+  }
+
+  void Resolve::operator()(For* f)
+  {
+    if (scopes.empty()) {
+      if (f->block()) f->block()->perform(this);
+      return;
+    }
+    // bounds are evaluated in the outer frame
+    visit_expression(f->lower_bound());
+    visit_expression(f->upper_bound());
+    std::vector<Symbol> names(1, Symbol_Table::intern(f->variable()));
+    visit_scope(f->block(), names);
+  }
+
+  void Resolve::operator()(Each* e)
+  {
+    if (scopes.empty()) {
+      if (e->block()) e->block()->perform(this);
+      return;
+    }
+    // list is evaluated in the outer frame
+    visit_expression(e->list());
+    std::vector<std::string> variables(e->variables());
+    std::vector<Symbol> names;
+    for (size_t i = 0, L = variables.size(); i < L; ++i) {
+      names.push_back(Symbol_Table::intern(variables[i]));
+    }
+    visit_scope(e->block(), names);
+  }
+
+  void Resolve::operator()(While* w)
+  {
+    if (scopes.empty()) {
+      if (w->block()) w->block()->perform(this);
+      return;
+    }
+    // predicate is evaluated in the new frame
+    scopes.push_back(std::vector<Symbol>());
+    visit_expression(w->predicate());
+    if (w->block()) w->block()->perform(this);
+    scopes.pop_back();
+  }
+
+  void Resolve::operator()(List* l)
+  {
+    for (size_t i = 0, L = l->length(); i < L; ++i) {
+      visit_expression((*l)[i]);
+    }
+  }
+
+  void Resolve::operator()(Map* m)
+  {
+    for (auto key : m->keys()) {
+      visit_expression(key);
+      visit_expression(m->at(key));
+    }
+  }
+
+  void Resolve::operator()(Binary_Expression* b)
+  {
+    visit_expression(b->left());
+    visit_expression(b->right());
+  }
+
+  void Resolve::operator()(Unary_Expression* u)
+  {
+    visit_expression(u->operand());
+  }
+
+  void Resolve::operator()(Function_Call* c)
+  {
+    visit_expression(c->arguments());
+  }
+
+  void Resolve::operator()(Function_Call_Schema* s)
+  {
+    visit_expression(s->name());
+    visit_expression(s->arguments());
+  }
+
+  void Resolve::operator()(String_Schema* s)
+  {
+    for (size_t i = 0, L = s->length(); i < L; ++i) {
+      visit_expression((*s)[i]);
+    }
+  }
+
+  void Resolve::operator()(Arguments* a)
+  {
+    for (size_t i = 0, L = a->length(); i < L; ++i) {
+      visit_expression((*a)[i]);
+    }
+  }
+
+  void Resolve::operator()(Argument* a)
+  {
+    visit_expression(a->value());
+  }
+
+  void Resolve::operator()(Variable* v)
+  {
+    v->depth(lookup(v->symbol()));
+  }
+
+}
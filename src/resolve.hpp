@@ -0,0 +1,71 @@
+#ifndef SASS_RESOLVE_H
+#define SASS_RESOLVE_H
+
+#include <vector>
+
+#include "ast.hpp"
+#include "operation.hpp"
+
+namespace Sass {
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Static pass between parsing and expansion. Inside function bodies the
+  // frames created by Eval follow the syntax exactly (one for the function
+  // and one for every control directive). References to parameters and loop
+  // variables therefore always hit a known frame and we store the distance
+  // to it on the Variable/Assignment nodes. Everything else is resolved
+  // dynamically as before (globals, mixins, introspection functions).
+  /////////////////////////////////////////////////////////////////////////////
+  class Resolve : public Operation_CRTP<void, Resolve> {
+
+    // names declared by each frame (innermost last)
+    std::vector<std::vector<Symbol> > scopes;
+
+    void fallback_impl(AST_Node* n) { }
+
+    // returns -1 if symbol has no static binding
+    int lookup(Symbol symbol);
+    void visit_scope(Block* b, const std::vector<Symbol>& names);
+    void visit_expression(Expression* ex);
+
+  public:
+    Resolve();
+    ~Resolve() { }
+
+    // statements
+    void operator()(Block*);
+    void operator()(Ruleset*);
+    void operator()(Media_Block*);
+    void operator()(Supports_Block*);
+    void operator()(At_Root_Block*);
+    void operator()(Directive*);
+    void operator()(Definition*);
+    void operator()(Assignment*);
+    void operator()(Return*);
+    void operator()(Warning*);
+    void operator()(Error*);
+    void operator()(Debug*);
+    void operator()(If*);
+    void operator()(For*);
+    void operator()(Each*);
+    void operator()(While*);
+
+    // expressions
+    void operator()(List*);
+    void operator()(Map*);
+    void operator()(Binary_Expression*);
+    void operator()(Unary_Expression*);
+    void operator()(Function_Call*);
+    void operator()(Function_Call_Schema*);
+    void operator()(String_Schema*);
+    void operator()(Arguments*);
+    void operator()(Argument*);
+    void operator()(Variable*);
+
+    template <typename U>
+    void fallback(U x) { return fallback_impl(x); }
+  };
+
+}
+
+#endif
@@ -212,36 +212,43 @@ extern "C" {
     return c_ctx->error_status;
   }
 
-  // generic compilation function (not exported, use file/data compile instead)
-  static Sass_Compiler* sass_prepare_context (Sass_Context* c_ctx, Context* cpp_ctx) throw()
+  // register custom functions, headers and importers from options
+  static void sass_register_custom (Sass_Options* c_opt, Context* cpp_ctx)
   {
-    try {
-      // register our custom functions
-      if (c_ctx->c_functions) {
-        auto this_func_data = c_ctx->c_functions;
-        while (this_func_data && *this_func_data) {
-          cpp_ctx->add_c_function(*this_func_data);
-          ++this_func_data;
-        }
+    // register our custom functions
+    if (c_opt->c_functions) {
+      auto this_func_data = c_opt->c_functions;
+      while (this_func_data && *this_func_data) {
+        cpp_ctx->add_c_function(*this_func_data);
+        ++this_func_data;
       }
+    }
 
-      // register our custom headers
-      if (c_ctx->c_headers) {
-        auto this_head_data = c_ctx->c_headers;
-        while (this_head_data && *this_head_data) {
-          cpp_ctx->add_c_header(*this_head_data);
-          ++this_head_data;
-        }
+    // register our custom headers
+    if (c_opt->c_headers) {
+      auto this_head_data = c_opt->c_headers;
+      while (this_head_data && *this_head_data) {
+        cpp_ctx->add_c_header(*this_head_data);
+        ++this_head_data;
       }
+    }
 
-      // register our custom importers
-      if (c_ctx->c_importers) {
-        auto this_imp_data = c_ctx->c_importers;
-        while (this_imp_data && *this_imp_data) {
-          cpp_ctx->add_c_importer(*this_imp_data);
-          ++this_imp_data;
-        }
+    // register our custom importers
+    if (c_opt->c_importers) {
+      auto this_imp_data = c_opt->c_importers;
+      while (this_imp_data && *this_imp_data) {
+        cpp_ctx->add_c_importer(*this_imp_data);
+        ++this_imp_data;
       }
+    }
+  }
+
+  // generic compilation function (not exported, use file/data compile instead)
+  static Sass_Compiler* sass_prepare_context (Sass_Context* c_ctx, Context* cpp_ctx) throw()
+  {
+    try {
+      // register our custom functions, headers and importers
+      sass_register_custom(c_ctx, cpp_ctx);
 
       // reset error status
       c_ctx->error_json = 0;
@@ -408,7 +415,8 @@ extern "C" {
     return sass_prepare_context(file_ctx, cpp_ctx);
   }
 
-  int ADDCALL sass_compile_data_context(Sass_Data_Context* data_ctx)
+  // setup is optional (used by compiler pools)
+  static int sass_compile_data(Sass_Data_Context* data_ctx, const Context* setup)
   {
     if (data_ctx == 0) return 1;
     if (data_ctx->error_status)
@@ -419,11 +427,12 @@ extern "C" {
       // if (*data_ctx->source_string == 0) { throw(std::runtime_error("Data context has empty source string")); }
     }
     catch (...) { return handle_errors(data_ctx) | 1; }
-    Context* cpp_ctx = new Data_Context(*data_ctx);
+    Context* cpp_ctx = new Data_Context(*data_ctx, setup);
     return sass_compile_context(data_ctx, cpp_ctx);
   }
 
-  int ADDCALL sass_compile_file_context(Sass_File_Context* file_ctx)
+  // setup is optional (used by compiler pools)
+  static int sass_compile_file(Sass_File_Context* file_ctx, const Context* setup)
   {
     if (file_ctx == 0) return 1;
     if (file_ctx->error_status)
@@ -433,10 +442,58 @@ extern "C" {
       if (*file_ctx->input_path == 0) { throw(std::runtime_error("File context has empty input path")); }
     }
     catch (...) { return handle_errors(file_ctx) | 1; }
-    Context* cpp_ctx = new File_Context(*file_ctx);
+    Context* cpp_ctx = new File_Context(*file_ctx, setup);
     return sass_compile_context(file_ctx, cpp_ctx);
   }
 
+  int ADDCALL sass_compile_data_context(Sass_Data_Context* data_ctx)
+  {
+    return sass_compile_data(data_ctx, 0);
+  }
+
+  int ADDCALL sass_compile_file_context(Sass_File_Context* file_ctx)
+  {
+    return sass_compile_file(file_ctx, 0);
+  }
+
+  struct Sass_Compiler_Pool* ADDCALL sass_make_compiler_pool (struct Sass_Options* options)
+  {
+    if (options == 0) return 0;
+    struct Sass_Compiler_Pool* pool = (struct Sass_Compiler_Pool*) calloc(1, sizeof(struct Sass_Compiler_Pool));
+    if (pool == 0) { std::cerr << "Error allocating memory for compiler pool" << std::endl; return 0; }
+    // the options are held by a context without source
+    // it is never compiled, it only does the setup once
+    pool->c_ctx = (struct Sass_Data_Context*) calloc(1, sizeof(struct Sass_Data_Context));
+    if (pool->c_ctx == 0) { std::cerr << "Error allocating memory for compiler pool" << std::endl; free(pool); return 0; }
+    pool->c_ctx->type = SASS_CONTEXT_DATA;
+    copy_options(pool->c_ctx, options);
+    try {
+      // loads plugins and collects include paths
+      pool->cpp_ctx = new Data_Context(*pool->c_ctx);
+      sass_register_custom(pool->c_ctx, pool->cpp_ctx);
+      // imported sheets are parsed once for all compilations
+      pool->parse_cache = new Parse_Cache();
+      pool->cpp_ctx->parse_cache = pool->parse_cache;
+    }
+    catch (...) {
+      sass_delete_compiler_pool(pool);
+      return 0;
+    }
+    return pool;
+  }
+
+  int ADDCALL sass_compiler_pool_compile_data (struct Sass_Compiler_Pool* pool, struct Sass_Data_Context* data_ctx)
+  {
+    if (pool == 0) return 1;
+    return sass_compile_data(data_ctx, pool->cpp_ctx);
+  }
+
+  int ADDCALL sass_compiler_pool_compile_file (struct Sass_Compiler_Pool* pool, struct Sass_File_Context* file_ctx)
+  {
+    if (pool == 0) return 1;
+    return sass_compile_file(file_ctx, pool->cpp_ctx);
+  }
+
   int ADDCALL sass_compiler_parse(struct Sass_Compiler* compiler)
   {
     if (compiler == 0) return 1;
@@ -603,6 +660,16 @@ extern "C" {
     sass_clear_context(ctx); free(ctx);
   }
 
+  // Deallocate the pool with its options
+  void ADDCALL sass_delete_compiler_pool (struct Sass_Compiler_Pool* pool)
+  {
+    if (pool == 0) return;
+    if (pool->cpp_ctx) delete(pool->cpp_ctx);
+    if (pool->parse_cache) delete(pool->parse_cache);
+    sass_delete_data_context(pool->c_ctx);
+    free(pool);
+  }
+
   // Getters for sass context from specific implementations
   struct Sass_Context* ADDCALL sass_file_context_get_context(struct Sass_File_Context* ctx) { return ctx; }
   struct Sass_Context* ADDCALL sass_data_context_get_context(struct Sass_Data_Context* ctx) { return ctx; }
@@ -638,6 +705,8 @@ extern "C" {
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Function_List, c_functions);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Importer_List, c_importers);
   IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Importer_List, c_headers);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(Sass_Output_Writer, output_writer);
+  IMPLEMENT_SASS_OPTION_ACCESSOR(void*, output_writer_cookie);
   IMPLEMENT_SASS_OPTION_ACCESSOR(const char*, indent);
   IMPLEMENT_SASS_OPTION_ACCESSOR(const char*, linefeed);
   IMPLEMENT_SASS_OPTION_STRING_ACCESSOR(const char*, input_path, 0);
@@ -4,6 +4,7 @@
 #include "sass.h"
 #include "sass.hpp"
 #include "context.hpp"
+#include "parse_cache.hpp"
 #include "ast_fwd_decl.hpp"
 
 // sass config options structure
@@ -63,6 +64,11 @@ struct Sass_Options : Sass_Output_Options {
   // List of custom headers
   Sass_Importer_List c_headers;
 
+  // Receives the output in chunks
+  // instead of the output string
+  Sass_Output_Writer output_writer;
+  void* output_writer_cookie;
+
 };
 
 
@@ -124,4 +130,15 @@ struct Sass_Compiler {
   Sass::Block* root;
 };
 
+// long lived setup for many compilations
+struct Sass_Compiler_Pool {
+  // options the pool was created with
+  Sass_Data_Context* c_ctx;
+  // holds cwd, include paths, plugins,
+  // custom functions, importers and headers
+  Sass::Context* cpp_ctx;
+  // parsed sheets shared by all compilations
+  Sass::Parse_Cache* parse_cache;
+};
+
 #endif
\ No newline at end of file
@@ -76,6 +76,7 @@ extern "C" {
     v->abs_path = abs_path ? sass_copy_c_string(abs_path) : 0;
     v->source = source;
     v->srcmap = srcmap;
+    v->cache_key = 0;
     v->error = 0;
     v->line = -1;
     v->column = -1;
@@ -99,6 +100,15 @@ extern "C" {
     return import;
   }
 
+  // Mark the returned source as stable to reuse the parsed style sheet (only used by compiler pools)
+  Sass_Import_Entry ADDCALL sass_import_set_cache_key(Sass_Import_Entry import, const char* key)
+  {
+    if (import == 0) return 0;
+    if (import->cache_key) free(import->cache_key);
+    import->cache_key = key ? sass_copy_c_string(key) : 0;
+    return import;
+  }
+
   // Setters and getters for entries on the import list
   void ADDCALL sass_import_set_list_entry(Sass_Import_List list, size_t idx, Sass_Import_Entry entry) { list[idx] = entry; }
   Sass_Import_Entry ADDCALL sass_import_get_list_entry(Sass_Import_List list, size_t idx) { return list[idx]; }
@@ -122,6 +132,7 @@ extern "C" {
     free(import->abs_path);
     free(import->source);
     free(import->srcmap);
+    free(import->cache_key);
     free(import->error);
     free(import);
   }
@@ -131,6 +142,7 @@ extern "C" {
   const char* ADDCALL sass_import_get_abs_path(Sass_Import_Entry entry) { return entry->abs_path; }
   const char* ADDCALL sass_import_get_source(Sass_Import_Entry entry) { return entry->source; }
   const char* ADDCALL sass_import_get_srcmap(Sass_Import_Entry entry) { return entry->srcmap; }
+  const char* ADDCALL sass_import_get_cache_key(Sass_Import_Entry entry) { return entry->cache_key; }
 
   // Getter for import error entry
   size_t ADDCALL sass_import_get_error_line(Sass_Import_Entry entry) { return entry->line; }
@@ -16,6 +16,8 @@ struct Sass_Import {
   char *abs_path; // path after importer has resolved it
   char* source;
   char* srcmap;
+  // opt in to the parse cache
+  char* cache_key;
   // error handling
   char* error;
   size_t line;
@@ -4,119 +4,226 @@
 #include <iostream>
 #include <cstddef>
 #include <iomanip>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
 
 #include "ast.hpp"
 #include "json.hpp"
 #include "context.hpp"
 #include "position.hpp"
 #include "source_map.hpp"
+#include "b64/encode.h"
 
 namespace Sass {
-  SourceMap::SourceMap() : current_position(0, 0, 0), file("stdin") { }
-  SourceMap::SourceMap(const std::string& file) : current_position(0, 0, 0), file(file) { }
+  SourceMap::SourceMap() : prefix_offset(0, 0), current_position(0, 0, 0), file("stdin") { }
+  SourceMap::SourceMap(const std::string& file) : prefix_offset(0, 0), current_position(0, 0, 0), file(file) { }
 
-  std::string SourceMap::render_srcmap(Context &ctx) {
+  // position after text of the given size was put in front
+  static Position shift(const Position& position, const Offset& offset)
+  {
+    return Position(position.file, offset + position);
+  }
+
+  // writes json without building a tree first
+  // the first pass (without buffer) only counts
+  class Json_Writer {
+  public:
+    Json_Writer(char* buffer) : buffer(buffer), size(0) { }
+    void raw(const char* str, size_t len)
+    {
+      if (buffer) std::memcpy(buffer + size, str, len);
+      size += len;
+    }
+    void raw(const char* str)
+    { raw(str, std::strlen(str)); }
+    void string(const char* str)
+    {
+      if (buffer) size = json_write_string(buffer + size, str) - buffer;
+      else size += json_string_length(str);
+    }
+  public:
+    char* buffer;
+    size_t size;
+  };
+
+  // same format as json_stringify with tab indentation
+  size_t SourceMap::write_srcmap(Context &ctx, const std::string& mappings, char* buffer) {
 
     const bool include_sources = ctx.c_options.source_map_contents;
-    const std::vector<std::string> links = ctx.srcmap_links;
+    const std::vector<std::string>& links(ctx.srcmap_links);
     const std::vector<Resource>& sources(ctx.resources);
 
-    JsonNode* json_srcmap = json_mkobject();
+    Json_Writer json(buffer);
 
-    json_append_member(json_srcmap, "version", json_mknumber(3));
+    json.raw("{\n\t\"version\": 3");
 
     // pass-through sourceRoot option
     if (!ctx.source_map_root.empty()) {
-      JsonNode* root = json_mkstring(ctx.source_map_root.c_str());
-      json_append_member(json_srcmap, "sourceRoot", root);
+      json.raw(",\n\t\"sourceRoot\": ");
+      json.string(ctx.source_map_root.c_str());
     }
 
-    const char *include = file.c_str();
-    JsonNode *json_include = json_mkstring(include);
-    json_append_member(json_srcmap, "file", json_include);
+    json.raw(",\n\t\"file\": ");
+    json.string(file.c_str());
 
-    JsonNode *json_includes = json_mkarray();
-    for (size_t i = 0; i < source_index.size(); ++i) {
-      const char *include = links[source_index[i]].c_str();
-      JsonNode *json_include = json_mkstring(include);
-      json_append_element(json_includes, json_include);
+    json.raw(",\n\t\"sources\": ");
+    if (source_index.empty()) json.raw("[]");
+    else {
+      json.raw("[\n");
+      for (size_t i = 0; i < source_index.size(); ++i) {
+        if (i) json.raw(",\n");
+        json.raw("\t\t");
+        json.string(links[i].c_str());
+      }
+      json.raw("\n\t]");
     }
-    json_append_member(json_srcmap, "sources", json_includes);
 
-    if (include_sources) {
-      JsonNode *json_contents = json_mkarray();
+    // source texts are escaped right into the buffer
+    if (include_sources && !source_index.empty()) {
+      json.raw(",\n\t\"sourcesContent\": [\n");
       for (size_t i = 0; i < source_index.size(); ++i) {
-        const Resource& resource(sources[source_index[i]]);
-        JsonNode *json_content = json_mkstring(resource.contents);
-        json_append_element(json_contents, json_content);
+        if (i) json.raw(",\n");
+        json.raw("\t\t");
+        json.string(sources[i].contents);
       }
-      if (json_contents->children.head)
-        json_append_member(json_srcmap, "sourcesContent", json_contents);
+      json.raw("\n\t]");
     }
 
-    std::string mappings = serialize_mappings();
-    JsonNode *json_mappings = json_mkstring(mappings.c_str());
-    json_append_member(json_srcmap, "mappings", json_mappings);
+    // only base64 characters and separators
+    // therefore nothing needs to be escaped
+    json.raw(",\n\t\"mappings\": \"");
+    json.raw(mappings.data(), mappings.size());
+    json.raw("\"");
 
-    JsonNode *json_names = json_mkarray();
     // so far we have no implementation for names
     // no problem as we do not alter any identifiers
-    json_append_member(json_srcmap, "names", json_names);
+    json.raw(",\n\t\"names\": []\n}");
 
-    char *str = json_stringify(json_srcmap, "\t");
-    std::string result = std::string(str);
-    free(str);
-    json_delete(json_srcmap);
+    return json.size;
+  }
+
+  void SourceMap::render_srcmap(Context &ctx, std::string& out, bool encode_base64) {
+
+    std::string mappings = serialize_mappings();
+    size_t size = write_srcmap(ctx, mappings, 0);
+    size_t offset = out.size();
+
+    if (!encode_base64) {
+      out.resize(offset + size);
+      write_srcmap(ctx, mappings, &out[offset]);
+      return;
+    }
+
+    // reserve the encoded size (and the newline
+    // base64_encode_blockend adds) and put the json
+    // at the end, so it can be encoded in place; the
+    // encoder never writes ahead of what it has read
+    size_t encoded = (size + 2) / 3 * 4;
+    out.resize(offset + encoded + 1);
+    char* code = &out[offset];
+    char* plain = code + encoded + 1 - size;
+    write_srcmap(ctx, mappings, plain);
+
+    base64::base64_encodestate state;
+    base64::base64_init_encodestate(&state);
+    // encoder takes an int length
+    const size_t chunk = 1 << 20;
+    for (size_t done = 0; done < size; done += chunk) {
+      int length = (int) std::min(chunk, size - done);
+      code += base64::base64_encode_block(plain + done, length, code, &state);
+    }
+    base64::base64_encode_blockend(code, &state);
+    // remove the newline
+    out.resize(offset + encoded);
+  }
+
+  std::string SourceMap::render_srcmap(Context &ctx) {
+    std::string result;
+    render_srcmap(ctx, result, false);
     return result;
   }
 
   std::string SourceMap::serialize_mappings() {
-    std::string result = "";
 
     size_t previous_generated_line = 0;
     size_t previous_generated_column = 0;
     size_t previous_original_line = 0;
     size_t previous_original_column = 0;
     size_t previous_original_file = 0;
+    // trees from the parse cache have their own
+    // ids, which we need to map to the sources
+    std::unordered_map<size_t, size_t> positions;
+    for (size_t i = 0; i < source_index.size(); ++i) {
+      if (source_index[i] != i) positions[source_index[i]] = i;
+    }
+
+    // upper bound: one semicolon per line, then
+    // a comma and four full numbers per mapping
+    const size_t prefix_size = prefix_mappings.size();
+    const size_t size = prefix_size + mappings.size();
+    size_t last_line = 0;
+    for (size_t i = 0; i < prefix_size; ++i) {
+      last_line = std::max(last_line, prefix_mappings[i].generated_position.line);
+    }
     for (size_t i = 0; i < mappings.size(); ++i) {
-      const size_t generated_line = mappings[i].generated_position.line;
-      const size_t generated_column = mappings[i].generated_position.column;
-      const size_t original_line = mappings[i].original_position.line;
-      const size_t original_column = mappings[i].original_position.column;
-      const size_t original_file = mappings[i].original_position.file;
+      last_line = std::max(last_line, prefix_offset.line + mappings[i].generated_position.line);
+    }
+    std::string result(last_line + size * (1 + 4 * Base64VLQ::MAX_LENGTH), 0);
+    char* out = &result[0];
+
+    for (size_t i = 0; i < size; ++i) {
+      const Mapping& mapping(i < prefix_size ? prefix_mappings[i] : mappings[i - prefix_size]);
+      const Position generated(i < prefix_size ? mapping.generated_position
+                               : shift(mapping.generated_position, prefix_offset));
+      const size_t generated_line = generated.line;
+      const size_t generated_column = generated.column;
+      const size_t original_line = mapping.original_position.line;
+      const size_t original_column = mapping.original_position.column;
+      size_t original_file = mapping.original_position.file;
+      if (!positions.empty()) {
+        std::unordered_map<size_t, size_t>::const_iterator it = positions.find(original_file);
+        if (it != positions.end()) original_file = it->second;
+      }
 
       if (generated_line != previous_generated_line) {
         previous_generated_column = 0;
         if (generated_line > previous_generated_line) {
-          result += std::string(generated_line - previous_generated_line, ';');
+          out = std::fill_n(out, generated_line - previous_generated_line, ';');
           previous_generated_line = generated_line;
         }
       }
       else if (i > 0) {
-        result += ",";
+        *out++ = ',';
       }
 
-      // generated column
-      result += base64vlq.encode(static_cast<int>(generated_column) - static_cast<int>(previous_generated_column));
+      const int segment[4] = {
+        // generated column
+        static_cast<int>(generated_column) - static_cast<int>(previous_generated_column),
+        // file
+        static_cast<int>(original_file) - static_cast<int>(previous_original_file),
+        // source line
+        static_cast<int>(original_line) - static_cast<int>(previous_original_line),
+        // source column
+        static_cast<int>(original_column) - static_cast<int>(previous_original_column)
+      };
+      out = base64vlq.encode(segment, 4, out);
+
       previous_generated_column = generated_column;
-      // file
-      result += base64vlq.encode(static_cast<int>(original_file) - static_cast<int>(previous_original_file));
       previous_original_file = original_file;
-      // source line
-      result += base64vlq.encode(static_cast<int>(original_line) - static_cast<int>(previous_original_line));
       previous_original_line = original_line;
-      // source column
-      result += base64vlq.encode(static_cast<int>(original_column) - static_cast<int>(previous_original_column));
       previous_original_column = original_column;
     }
 
+    result.resize(out - result.data());
     return result;
   }
 
   void SourceMap::prepend(const OutputBuffer& out)
   {
-    Offset size(out.smap.current_position);
-    for (Mapping mapping : out.smap.mappings) {
+    std::vector<Mapping> prepended(out.smap.generated_mappings());
+    Offset size(out.smap.prefix_offset + out.smap.current_position);
+    for (Mapping mapping : prepended) {
       if (mapping.generated_position.line > size.line) {
         throw(std::runtime_error("prepend sourcemap has illegal line"));
       }
@@ -127,32 +234,25 @@ namespace Sass {
       }
     }
     // will adjust the offset
-    prepend(Offset(out.buffer));
+    prepend(out.offset());
     // now add the new mappings
-    VECTOR_UNSHIFT(mappings, out.smap.mappings);
+    VECTOR_UNSHIFT(prefix_mappings, prepended);
   }
 
   void SourceMap::append(const OutputBuffer& out)
   {
-    append(Offset(out.buffer));
+    append(out.offset());
   }
 
   void SourceMap::prepend(const Offset& offset)
   {
     if (offset.line != 0 || offset.column != 0) {
-      for (Mapping& mapping : mappings) {
-        // move stuff on the first old line
-        if (mapping.generated_position.line == 0) {
-          mapping.generated_position.column += offset.column;
-        }
-        // make place for the new lines
-        mapping.generated_position.line += offset.line;
+      // only the prepended mappings are moved now
+      for (Mapping& mapping : prefix_mappings) {
+        mapping.generated_position = shift(mapping.generated_position, offset);
       }
+      prefix_offset = offset + prefix_offset;
     }
-    if (current_position.line == 0) {
-      current_position.column += offset.column;
-    }
-    current_position.line += offset.line;
   }
 
   void SourceMap::append(const Offset& offset)
@@ -160,6 +260,17 @@ namespace Sass {
     current_position += offset;
   }
 
+  std::vector<Mapping> SourceMap::generated_mappings() const
+  {
+    std::vector<Mapping> result(prefix_mappings);
+    result.reserve(prefix_mappings.size() + mappings.size());
+    for (const Mapping& mapping : mappings) {
+      result.push_back(Mapping(mapping.original_position,
+                               shift(mapping.generated_position, prefix_offset)));
+    }
+    return result;
+  }
+
   void SourceMap::add_open_mapping(const AST_Node* node)
   {
     mappings.push_back(Mapping(node->pstate(), current_position));
@@ -171,15 +282,74 @@ namespace Sass {
   }
 
   ParserState SourceMap::remap(const ParserState& pstate) {
-    for (size_t i = 0; i < mappings.size(); ++i) {
+    std::vector<Mapping> generated(generated_mappings());
+    for (size_t i = 0; i < generated.size(); ++i) {
       if (
-        mappings[i].generated_position.file == pstate.file &&
-        mappings[i].generated_position.line == pstate.line &&
-        mappings[i].generated_position.column == pstate.column
-      ) return ParserState(pstate.path, pstate.src, mappings[i].original_position, pstate.offset);
+        generated[i].generated_position.file == pstate.file &&
+        generated[i].generated_position.line == pstate.line &&
+        generated[i].generated_position.column == pstate.column
+      ) return ParserState(pstate.path, pstate.src, generated[i].original_position, pstate.offset);
     }
     return ParserState(pstate.path, pstate.src, Position(-1, -1, -1), Offset(0, 0));
 
   }
 
+  void OutputBuffer::prepend(const OutputBuffer& out)
+  {
+    // last segment of out is the first to prepend
+    for (size_t i = out.tail.size(); i > 0; --i) head.push_back(out.tail[i - 1]);
+    head.push_back(out.buffer);
+    for (size_t i = 0; i < out.head.size(); ++i) head.push_back(out.head[i]);
+  }
+
+  size_t OutputBuffer::size() const
+  {
+    size_t size = buffer.size();
+    for (const std::string& segment : head) size += segment.size();
+    for (const std::string& segment : tail) size += segment.size();
+    return size;
+  }
+
+  bool OutputBuffer::ends_with(const std::string& str) const
+  {
+    // str may span several segments
+    size_t left = str.size();
+    std::vector<const std::string*> segments;
+    for (size_t i = tail.size(); i > 0; --i) segments.push_back(&tail[i - 1]);
+    segments.push_back(&buffer);
+    for (const std::string& segment : head) segments.push_back(&segment);
+    for (const std::string* segment : segments) {
+      size_t len = std::min(left, segment->size());
+      if (segment->compare(segment->size() - len, len, str, left - len, len) != 0) return false;
+      left -= len;
+      if (left == 0) return true;
+    }
+    return left == 0;
+  }
+
+  Offset OutputBuffer::offset() const
+  {
+    Offset offset(0, 0);
+    for (size_t i = head.size(); i > 0; --i) offset.add(head[i - 1].data(), head[i - 1].data() + head[i - 1].size());
+    offset.add(buffer.data(), buffer.data() + buffer.size());
+    for (const std::string& segment : tail) offset.add(segment.data(), segment.data() + segment.size());
+    return offset;
+  }
+
+  char* OutputBuffer::write(char* out) const
+  {
+    for (size_t i = head.size(); i > 0; --i) out = std::copy(head[i - 1].begin(), head[i - 1].end(), out);
+    out = std::copy(buffer.begin(), buffer.end(), out);
+    for (const std::string& segment : tail) out = std::copy(segment.begin(), segment.end(), out);
+    return out;
+  }
+
+  std::string OutputBuffer::str() const
+  {
+    if (head.empty() && tail.empty()) return buffer;
+    std::string str(size(), 0);
+    write(&str[0]);
+    return str;
+  }
+
 }
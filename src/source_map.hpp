@@ -32,13 +32,25 @@ namespace Sass {
     void add_close_mapping(const AST_Node* node);
 
     std::string render_srcmap(Context &ctx);
+    // appends the map to out, optionally base64 encoded
+    void render_srcmap(Context &ctx, std::string& out, bool encode_base64);
     ParserState remap(const ParserState& pstate);
 
   private:
 
     std::string serialize_mappings();
+    // returns the size of the json and writes it to buffer if given
+    size_t write_srcmap(Context &ctx, const std::string& mappings, char* buffer);
+    // all mappings with their final generated position
+    std::vector<Mapping> generated_mappings() const;
 
+    // mappings of prepended outputs (final positions)
+    std::vector<Mapping> prefix_mappings;
+    // mappings and position are relative to the text that
+    // was appended; prepending only moves this offset and
+    // it is applied when the positions are needed
     std::vector<Mapping> mappings;
+    Offset prefix_offset;
     Position current_position;
 public:
     std::string file;
@@ -46,15 +58,41 @@ private:
     Base64VLQ base64vlq;
   };
 
+  /////////////////////////////////////////////////////////////////////////////
+  // The emitters append to `buffer`. Text added in front or at the end is kept
+  // in separate segments, so the main buffer is never copied. The segments of
+  // `head` are stored in reverse order (the last one is the first to output).
+  /////////////////////////////////////////////////////////////////////////////
   class OutputBuffer {
     public:
       OutputBuffer(void)
       : buffer(""),
+        head(),
+        tail(),
         smap()
       { }
     public:
       std::string buffer;
+      std::vector<std::string> head;
+      std::vector<std::string> tail;
       SourceMap smap;
+    public:
+      void prepend(const std::string& text)
+      { head.push_back(text); }
+      void prepend(const OutputBuffer& out);
+      void append(const std::string& text)
+      { tail.push_back(text); }
+      // size of the complete text
+      size_t size() const;
+      bool empty() const
+      { return size() == 0; }
+      bool ends_with(const std::string& str) const;
+      // offset of the complete text
+      Offset offset() const;
+      // writes the complete text, returns the end
+      char* write(char* out) const;
+      // the complete text as one string
+      std::string str() const;
   };
 
 }
@@ -1,11 +1,9 @@
 #ifndef SASS_SUBSET_MAP_H
 #define SASS_SUBSET_MAP_H
 
-#include <map>
-#include <set>
 #include <vector>
 #include <algorithm>
-#include <iterator>
+#include <unordered_map>
 
 
 // #include <iostream>
@@ -56,31 +54,40 @@
 
 namespace Sass {
 
-  template<typename F, typename S, typename T>
-  struct triple {
-    F first;
-    S second;
-    T third;
-
-    triple(const F& f, const S& s, const T& t) : first(f), second(s), third(t) { }
-  };
-
-  template<typename F, typename S, typename T>
-  triple<F, S, T> make_triple(const F& f, const S& s, const T& t)
-  { return triple<F, S, T>(f, s, t); }
-
+  /////////////////////////////////////////////////////////////////////////////
+  // Maps sets of keys to values and returns all values whose key set is a
+  // subset of the given keys (in the order they were put). Keys are interned
+  // to ids and every entry keeps its ids sorted. Each entry is only indexed
+  // by its smallest id, so a lookup visits every candidate exactly once and
+  // checks it against the sorted ids of the probe. Nothing is copied except
+  // the results. Lookups do not modify the map and may run concurrently.
+  /////////////////////////////////////////////////////////////////////////////
   template<typename K, typename V>
   class Subset_Map {
   private:
+    struct Entry {
+      // keys as they were put
+      std::vector<K> keys;
+      // sorted unique key ids
+      std::vector<size_t> ids;
+    };
     std::vector<V> values_;
-    std::map<K, std::vector<triple<std::vector<K>, std::set<K>, size_t> > > hash_;
+    std::vector<Entry> entries_;
+    std::unordered_map<K, size_t> ids_;
+    // entries by their smallest key id
+    std::vector<std::vector<size_t> > index_;
+  private:
+    // sorted unique ids of the known keys
+    void probe(const std::vector<K>& s, std::vector<size_t>& ids) const;
+    // indices of all entries that are a subset
+    void find(const std::vector<K>& s, std::vector<size_t>& found) const;
   public:
     void put(const std::vector<K>& s, const V& value);
-    std::vector<std::pair<V, std::vector<K> > > get_kv(const std::vector<K>& s);
-    std::vector<V> get_v(const std::vector<K>& s);
-    bool empty() { return values_.empty(); }
-    void clear() { values_.clear(); hash_.clear(); }
-    const std::vector<V> values(void) { return values_; }
+    std::vector<std::pair<V, std::vector<K> > > get_kv(const std::vector<K>& s) const;
+    std::vector<V> get_v(const std::vector<K>& s) const;
+    bool empty() const { return values_.empty(); }
+    void clear() { values_.clear(); entries_.clear(); ids_.clear(); index_.clear(); }
+    const std::vector<V>& values(void) const { return values_; }
   };
 
   template<typename K, typename V>
@@ -89,53 +96,68 @@ namespace Sass {
     if (s.empty()) throw "internal error: subset map keys may not be empty";
     size_t index = values_.size();
     values_.push_back(value);
-    std::set<K> ss;
-    for (size_t i = 0, S = s.size(); i < S; ++i)
-    { ss.insert(s[i]); }
-    for (size_t i = 0, S = s.size(); i < S; ++i)
-    {
-      hash_[s[i]].push_back(make_triple(s, ss, index));
+    entries_.push_back(Entry());
+    Entry& entry = entries_.back();
+    entry.keys = s;
+    for (size_t i = 0, S = s.size(); i < S; ++i) {
+      entry.ids.push_back(ids_.insert(std::make_pair(s[i], ids_.size())).first->second);
     }
+    std::sort(entry.ids.begin(), entry.ids.end());
+    entry.ids.erase(std::unique(entry.ids.begin(), entry.ids.end()), entry.ids.end());
+    if (index_.size() < ids_.size()) index_.resize(ids_.size());
+    index_[entry.ids.front()].push_back(index);
   }
 
   template<typename K, typename V>
-  std::vector<std::pair<V, std::vector<K> > > Subset_Map<K, V>::get_kv(const std::vector<K>& s)
+  void Subset_Map<K, V>::probe(const std::vector<K>& s, std::vector<size_t>& ids) const
   {
-    std::vector<K> sorted = s;
-    sort(sorted.begin(), sorted.end());
-    std::vector<std::pair<size_t, std::vector<K> > > indices;
     for (size_t i = 0, S = s.size(); i < S; ++i) {
-      if (!hash_.count(s[i])) {
-        continue;
-      }
-      std::vector<triple<std::vector<K>, std::set<K>, size_t> > subsets = hash_[s[i]];
-      // std::cerr << "length of subsets: " << subsets.size() << std::endl;
-      for (size_t j = 0, T = subsets.size(); j < T; ++j) {
-        if (!includes(sorted.begin(), sorted.end(), subsets[j].second.begin(), subsets[j].second.end())) {
-          // std::cout << vector_to_string(s) << " doesn't include " << set_to_string(subsets[j].second) << std::endl;
-          continue;
+      typename std::unordered_map<K, size_t>::const_iterator it = ids_.find(s[i]);
+      if (it != ids_.end()) ids.push_back(it->second);
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  }
+
+  template<typename K, typename V>
+  void Subset_Map<K, V>::find(const std::vector<K>& s, std::vector<size_t>& found) const
+  {
+    std::vector<size_t> ids;
+    probe(s, ids);
+    for (size_t i = 0, S = ids.size(); i < S; ++i) {
+      const std::vector<size_t>& candidates = index_[ids[i]];
+      for (size_t j = 0, T = candidates.size(); j < T; ++j) {
+        const std::vector<size_t>& subset = entries_[candidates[j]].ids;
+        // smallest id is known to match
+        if (std::includes(ids.begin() + i + 1, ids.end(), subset.begin() + 1, subset.end())) {
+          found.push_back(candidates[j]);
         }
-        indices.push_back(std::make_pair(subsets[j].third, subsets[j].first));
-        // std::cerr << "pushed " << subsets[j].third << " and " << vector_to_string(subsets[j].first) << " onto indices" << std::endl;
       }
     }
-    sort(indices.begin(), indices.end());
-    typename std::vector<std::pair<size_t, std::vector<K> > >::iterator indices_end = unique(indices.begin(), indices.end());
-    indices.resize(distance(indices.begin(), indices_end));
+    std::sort(found.begin(), found.end());
+  }
 
+  template<typename K, typename V>
+  std::vector<std::pair<V, std::vector<K> > > Subset_Map<K, V>::get_kv(const std::vector<K>& s) const
+  {
+    std::vector<size_t> found;
+    find(s, found);
     std::vector<std::pair<V, std::vector<K> > > results;
-    for (size_t i = 0, S = indices.size(); i < S; ++i) {
-      results.push_back(std::make_pair(values_[indices[i].first], indices[i].second));
+    results.reserve(found.size());
+    for (size_t i = 0, S = found.size(); i < S; ++i) {
+      results.push_back(std::make_pair(values_[found[i]], entries_[found[i]].keys));
     }
     return results;
   }
 
   template<typename K, typename V>
-  std::vector<V> Subset_Map<K, V>::get_v(const std::vector<K>& s)
+  std::vector<V> Subset_Map<K, V>::get_v(const std::vector<K>& s) const
   {
-    std::vector<std::pair<V, std::vector<K> > > kvs = get_kv(s);
+    std::vector<size_t> found;
+    find(s, found);
     std::vector<V> results;
-    for (size_t i = 0, S = kvs.size(); i < S; ++i) results.push_back(kvs[i].first);
+    results.reserve(found.size());
+    for (size_t i = 0, S = found.size(); i < S; ++i) results.push_back(values_[found[i]]);
     return results;
   }
 
@@ -0,0 +1,163 @@
+#include "sass.hpp"
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include "symbol_table.hpp"
+
+namespace Sass {
+
+  // names live in chunks that double in size and never move
+  // the first chunk holds 64 names, all chunks 64 * (2^26 - 1)
+  static const size_t FIRST_CHUNK_BITS = 6;
+  static const size_t MAX_CHUNKS = 26;
+
+  // open addressing hash index over the symbols
+  // empty slots are zero, the index is replaced on growth
+  struct Symbol_Index {
+    size_t mask;
+    std::atomic<Symbol>* slots;
+    Symbol_Index(size_t capacity)
+    : mask(capacity - 1), slots(new std::atomic<Symbol>[capacity])
+    { for (size_t i = 0; i < capacity; ++i) slots[i].store(0, std::memory_order_relaxed); }
+    ~Symbol_Index() { delete[] slots; }
+  };
+
+  // readers never lock: a name is stored before the size
+  // and its index slot are published (release/acquire)
+  // writers are serialized by the lock
+  class Symbol_Store {
+    std::mutex lock;
+    std::atomic<std::string*> chunks[MAX_CHUNKS];
+    std::atomic<Symbol> size;
+    std::atomic<Symbol_Index*> index;
+    // replaced indexes may still be read by other threads
+    std::vector<Symbol_Index*> retired;
+    std::hash<std::string> hasher;
+
+    static void locate(Symbol sym, size_t& chunk, size_t& offset)
+    {
+      size_t pos = size_t(sym) + (size_t(1) << FIRST_CHUNK_BITS);
+      chunk = 0;
+      while (pos >> (FIRST_CHUNK_BITS + chunk + 1)) ++ chunk;
+      offset = pos - (size_t(1) << (FIRST_CHUNK_BITS + chunk));
+    }
+
+    const std::string& at(Symbol sym) const
+    {
+      size_t chunk, offset;
+      locate(sym, chunk, offset);
+      return chunks[chunk].load(std::memory_order_acquire)[offset];
+    }
+
+    Symbol lookup(const Symbol_Index* idx, const std::string& name) const
+    {
+      for (size_t i = hasher(name) & idx->mask; ; i = (i + 1) & idx->mask) {
+        Symbol sym = idx->slots[i].load(std::memory_order_acquire);
+        if (sym == 0 || at(sym) == name) return sym;
+      }
+    }
+
+    void insert(Symbol_Index* idx, Symbol sym)
+    {
+      size_t i = hasher(at(sym)) & idx->mask;
+      while (idx->slots[i].load(std::memory_order_relaxed)) i = (i + 1) & idx->mask;
+      idx->slots[i].store(sym, std::memory_order_release);
+    }
+
+  public:
+    Symbol_Store()
+    : size(0), index(new Symbol_Index(128))
+    {
+      for (size_t i = 0; i < MAX_CHUNKS; ++i) chunks[i].store(0);
+      // reserve zero with an empty name
+      intern("");
+    }
+
+    ~Symbol_Store()
+    {
+      for (size_t i = 0; i < MAX_CHUNKS; ++i) delete[] chunks[i].load();
+      for (size_t i = 0, S = retired.size(); i < S; ++i) delete retired[i];
+      delete index.load();
+    }
+
+    Symbol find(const std::string& name) const
+    {
+      return lookup(index.load(std::memory_order_acquire), name);
+    }
+
+    const std::string& name(Symbol sym) const
+    {
+      if (sym >= size.load(std::memory_order_acquire)) return at(0);
+      return at(sym);
+    }
+
+    Symbol intern(const std::string& name)
+    {
+      if (Symbol sym = find(name)) return sym;
+      std::lock_guard<std::mutex> guard(lock);
+      Symbol_Index* idx = index.load(std::memory_order_relaxed);
+      // check again, another thread may have added it
+      if (Symbol sym = lookup(idx, name)) return sym;
+      Symbol sym = size.load(std::memory_order_relaxed);
+      // the empty name is only interned once, as symbol zero
+      if (sym && name.empty()) return 0;
+      size_t chunk, offset;
+      locate(sym, chunk, offset);
+      if (chunk >= MAX_CHUNKS) throw std::length_error("too many symbols");
+      std::string* names = chunks[chunk].load(std::memory_order_relaxed);
+      if (!names) {
+        names = new std::string[size_t(1) << (FIRST_CHUNK_BITS + chunk)];
+        chunks[chunk].store(names, std::memory_order_release);
+      }
+      names[offset] = name;
+      size.store(sym + 1, std::memory_order_release);
+      if (sym == 0) return sym;
+      // keep the load factor below one half
+      if ((size_t(sym) + 1) * 2 > idx->mask + 1) {
+        Symbol_Index* grown = new Symbol_Index((idx->mask + 1) * 2);
+        for (Symbol s = 1; s < sym; ++s) insert(grown, s);
+        retired.push_back(idx);
+        idx = grown;
+        index.store(idx, std::memory_order_release);
+      }
+      insert(idx, sym);
+      return sym;
+    }
+  };
+
+  // keep the state in a function to avoid
+  // any issues with static initialization order
+  static Symbol_Store& symbol_store()
+  {
+    static Symbol_Store store;
+    return store;
+  }
+
+  Symbol Symbol_Table::intern(const std::string& name)
+  {
+    return symbol_store().intern(name);
+  }
+
+  Symbol Symbol_Table::find(const std::string& name)
+  {
+    return symbol_store().find(name);
+  }
+
+  const std::string& Symbol_Table::name(Symbol sym)
+  {
+    return symbol_store().name(sym);
+  }
+
+  namespace Symbols {
+    extern const Symbol generic_fn = Symbol_Table::intern("*[f]");
+    extern const Symbol call_fn = Symbol_Table::intern("call[f]");
+    extern const Symbol if_fn = Symbol_Table::intern("if[f]");
+    extern const Symbol warn_fn = Symbol_Table::intern("@warn[f]");
+    extern const Symbol error_fn = Symbol_Table::intern("@error[f]");
+    extern const Symbol debug_fn = Symbol_Table::intern("@debug[f]");
+    extern const Symbol content_mixin = Symbol_Table::intern("@content[m]");
+  }
+
+}
@@ -0,0 +1,46 @@
+#ifndef SASS_SYMBOL_TABLE_H
+#define SASS_SYMBOL_TABLE_H
+
+#include <string>
+#include <stdint.h>
+
+namespace Sass {
+
+  // identifiers are interned to small integers
+  // zero is reserved and never handed out
+  typedef uint32_t Symbol;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Process wide table of interned identifiers (variable, function and mixin
+  // names, plus custom units). The parser interns the names it sees, so
+  // environments can be keyed by plain integers and lookups no longer need to
+  // compare strings. Names that only show up at runtime (string arguments of
+  // built-ins) are looked up with `find`, which never adds to the table.
+  // Names are kept in storage that never moves, so `find` and `name` do not
+  // lock; only adding a new name is serialized. Symbols are never released,
+  // so long lived hosts (compiler pools, watchers) keep every distinct name.
+  /////////////////////////////////////////////////////////////////////////////
+  class Symbol_Table {
+  public:
+    // get the symbol for name (create it if needed)
+    static Symbol intern(const std::string& name);
+    // get the symbol for name or zero if it was never interned
+    static Symbol find(const std::string& name);
+    // get back the name for the given symbol
+    static const std::string& name(Symbol sym);
+  };
+
+  // symbols we need to look up ourself
+  namespace Symbols {
+    extern const Symbol generic_fn;
+    extern const Symbol call_fn;
+    extern const Symbol if_fn;
+    extern const Symbol warn_fn;
+    extern const Symbol error_fn;
+    extern const Symbol debug_fn;
+    extern const Symbol content_mixin;
+  }
+
+}
+
+#endif
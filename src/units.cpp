@@ -1,6 +1,7 @@
 #include "sass.hpp"
 #include <stdexcept>
 #include "units.hpp"
+#include "symbol_table.hpp"
 
 namespace Sass {
 
@@ -160,35 +161,107 @@ namespace Sass {
     return "CUSTOM:" + s;
   }
 
+  // names of known units by class and index
+  struct Known_Units {
+    std::string names[5][6];
+    Known_Units()
+    {
+      for (size_t t = 0; t < 5; ++t) {
+        for (size_t i = 0; i < 6; ++i) {
+          names[t][i] = unit_to_string(UnitType((t << 8) + i));
+        }
+      }
+    }
+  };
+
+  static const Known_Units& known_units()
+  {
+    static const Known_Units known;
+    return known;
+  }
+
+  // custom units share the storage of the symbol table
+  Unit intern_unit(const std::string& name)
+  {
+    UnitType type = string_to_unit(name);
+    if (type != UNKNOWN) return type;
+    return CUSTOM_UNIT + Symbol_Table::intern(name);
+  }
+
+  const std::string& unit_name(Unit unit)
+  {
+    if (unit < CUSTOM_UNIT) return known_units().names[unit >> 8][unit & 0xFF];
+    return Symbol_Table::name(unit - CUSTOM_UNIT);
+  }
+
+  Unit_Exponents::Unit_Exponents(const Unit_List& numerators, const Unit_List& denominators)
+  {
+    for (size_t i = 0, S = numerators.size(); i < S; ++i) ++ (*this)[numerators[i]];
+    for (size_t i = 0, S = denominators.size(); i < S; ++i) -- (*this)[denominators[i]];
+  }
+
+  int& Unit_Exponents::operator[](Unit unit)
+  {
+    for (size_t i = 0, S = exponents.size(); i < S; ++i) {
+      if (exponents[i].first == unit) return exponents[i].second;
+    }
+    exponents.push_back(std::make_pair(unit, 0));
+    return exponents[exponents.size() - 1].second;
+  }
+
+  void Unit_Exponents::build(Unit_List& numerators, Unit_List& denominators) const
+  {
+    numerators.clear();
+    denominators.clear();
+    // sort the remaining units by name
+    // resolve every name once, not per comparison
+    Small_Vector<std::pair<Unit, int>, 4> sorted;
+    Small_Vector<const std::string*, 4> names;
+    for (size_t i = 0, S = exponents.size(); i < S; ++i) {
+      if (exponents[i].second == 0) continue;
+      sorted.push_back(exponents[i]);
+      names.push_back(&unit_name(exponents[i].first));
+      for (size_t j = sorted.size() - 1; j > 0; --j) {
+        if (!(*names[j] < *names[j - 1])) break;
+        std::swap(sorted[j], sorted[j - 1]);
+        std::swap(names[j], names[j - 1]);
+      }
+    }
+    for (size_t i = 0, S = sorted.size(); i < S; ++i) {
+      Unit unit = sorted[i].first;
+      int exponent = sorted[i].second;
+      for (; exponent < 0; ++ exponent) denominators.push_back(unit);
+      for (; exponent > 0; -- exponent) numerators.push_back(unit);
+    }
+  }
+
   // throws incompatibleUnits exceptions
-  double conversion_factor(const std::string& s1, const std::string& s2, bool strict)
+  double conversion_factor(Unit u1, Unit u2, bool strict)
   {
     // assert for same units
-    if (s1 == s2) return 1;
-    // get unit enum from string
-    UnitType u1 = string_to_unit(s1);
-    UnitType u2 = string_to_unit(s2);
+    if (u1 == u2) return 1;
     // query unit group types
-    UnitClass t1 = get_unit_type(u1);
-    UnitClass t2 = get_unit_type(u2);
+    UnitClass t1 = get_unit_type(unit_type(u1));
+    UnitClass t2 = get_unit_type(unit_type(u2));
+    // error if units are not of the same group
+    // don't error for multiplication and division
+    // but do not convert them either
+    if (t1 != t2) {
+      if (strict) throw incompatibleUnits(u1, u2);
+      return 0;
+    }
     // get absolute offset
     // used for array acces
     size_t i1 = u1 - t1;
     size_t i2 = u2 - t2;
-    // error if units are not of the same group
-    // don't error for multiplication and division
-    if (strict && t1 != t2) throw incompatibleUnits(u1, u2);
-    // only process known units
-    if (u1 != UNKNOWN && u2 != UNKNOWN) {
-      switch (t1) {
-        case UnitClass::LENGTH:            return size_conversion_factors[i1][i2]; break;
-        case UnitClass::ANGLE:             return angle_conversion_factors[i1][i2]; break;
-        case UnitClass::TIME:              return time_conversion_factors[i1][i2]; break;
-        case UnitClass::FREQUENCY:         return frequency_conversion_factors[i1][i2]; break;
-        case UnitClass::RESOLUTION:        return resolution_conversion_factors[i1][i2]; break;
-        // ToDo: should we throw error here?
-        case UnitClass::INCOMMENSURABLE:   return 0; break;
-      }
+    switch (t1) {
+      case UnitClass::LENGTH:            return size_conversion_factors[i1][i2]; break;
+      case UnitClass::ANGLE:             return angle_conversion_factors[i1][i2]; break;
+      case UnitClass::TIME:              return time_conversion_factors[i1][i2]; break;
+      case UnitClass::FREQUENCY:         return frequency_conversion_factors[i1][i2]; break;
+      case UnitClass::RESOLUTION:        return resolution_conversion_factors[i1][i2]; break;
+      // custom units only convert to themself
+      case UnitClass::INCOMMENSURABLE:   return 0; break;
     }
     // fallback
     return 0;
@@ -3,7 +3,10 @@
 
 #include <cmath>
 #include <string>
+#include <vector>
 #include <sstream>
+#include <algorithm>
+#include <stdint.h>
 
 namespace Sass {
 
@@ -58,32 +61,109 @@ namespace Sass {
   extern const double frequency_conversion_factors[2][2];
   extern const double resolution_conversion_factors[3][3];
 
+  // Units of numbers are interned to small integers. Known units use
+  // their UnitType value, so class and table index are encoded in the
+  // id itself. All other units are interned in the symbol table.
+  // Arithmetic only compares ids and never needs the unit names.
+  typedef uint32_t Unit;
+  // first id handed out for custom units
+  const Unit CUSTOM_UNIT = 0x1000;
+
+  // get the id for the unit name (create it if needed)
+  Unit intern_unit(const std::string& name);
+  // get back the name for the given id
+  const std::string& unit_name(Unit unit);
+  // custom units are all incommensurable
+  inline UnitType unit_type(Unit unit)
+  { return unit < CUSTOM_UNIT ? UnitType(unit) : UNKNOWN; }
+
+  /////////////////////////////////////////////////////////////////////////
+  // Small vector with inline storage for the first N items. Most numbers
+  // have at most one unit, so copying them does not need to allocate.
+  /////////////////////////////////////////////////////////////////////////
+  template <typename T, size_t N>
+  class Small_Vector {
+    size_t size_;
+    T inline_[N];
+    std::vector<T> heap_;
+    T* data() { return size_ > N ? &heap_[0] : inline_; }
+    const T* data() const { return size_ > N ? &heap_[0] : inline_; }
+  public:
+    typedef const T* const_iterator;
+    Small_Vector() : size_(0) { }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](size_t i) { return data()[i]; }
+    const T& operator[](size_t i) const { return data()[i]; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size_; }
+    void clear() { size_ = 0; heap_.clear(); }
+    void push_back(const T& item)
+    {
+      if (size_ < N) inline_[size_] = item;
+      else {
+        // move everything to the heap once
+        if (size_ == N) heap_.assign(inline_, inline_ + N);
+        heap_.push_back(item);
+      }
+      ++ size_;
+    }
+    void erase(size_t i)
+    {
+      T* items = data();
+      std::copy(items + i + 1, items + size_, items + i);
+      -- size_;
+      if (size_ > N) heap_.pop_back();
+      else if (size_ == N) {
+        // back to the inline storage
+        std::copy(heap_.begin(), heap_.begin() + N, inline_);
+        heap_.clear();
+      }
+    }
+    bool operator==(const Small_Vector& rhs) const
+    { return size_ == rhs.size_ && std::equal(begin(), end(), rhs.begin()); }
+    bool operator!=(const Small_Vector& rhs) const
+    { return !(*this == rhs); }
+  };
+
+  typedef Small_Vector<Unit, 2> Unit_List;
+
+  // sums up the exponent of each unit and builds sorted unit lists
+  class Unit_Exponents {
+    Small_Vector<std::pair<Unit, int>, 4> exponents;
+  public:
+    Unit_Exponents(const Unit_List& numerators, const Unit_List& denominators);
+    int& operator[](Unit unit);
+    // units ordered by name (as we always did)
+    void build(Unit_List& numerators, Unit_List& denominators) const;
+  };
+
   enum Sass::UnitType string_to_unit(const std::string&);
   const char* unit_to_string(Sass::UnitType unit);
   enum Sass::UnitClass get_unit_type(Sass::UnitType unit);
   std::string get_unit_class(Sass::UnitType unit);
   std::string unit_to_class(const std::string&);
   // throws incompatibleUnits exceptions
-  double conversion_factor(const std::string&, const std::string&, bool = true);
+  // returns 0 if the units cannot be converted
+  double conversion_factor(Unit, Unit, bool = true);
 
   class incompatibleUnits: public std::exception
   {
     public:
-      const char* msg;
-      incompatibleUnits(Sass::UnitType a, Sass::UnitType b)
+      std::string msg;
+      incompatibleUnits(Unit a, Unit b)
       : exception()
       {
         std::stringstream ss;
         ss << "Incompatible units: ";
-        ss << "'" << unit_to_string(a) << "' and ";
-        ss << "'" << unit_to_string(b) << "'";
-        // hold on to string on stack!
-        std::string str(ss.str());
-        msg = str.c_str();
+        ss << "'" << unit_name(a) << "' and ";
+        ss << "'" << unit_name(b) << "'";
+        msg = ss.str();
       }
+      virtual ~incompatibleUnits() throw() { }
       virtual const char* what() const throw()
       {
-        return msg;
+        return msg.c_str();
       }
   };
 
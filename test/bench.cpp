@@ -0,0 +1,355 @@
+// measures hot paths of libsass on generated inputs and prints
+// the timings; the test programs check the results, not this one
+// pass the names of cases to run only those, scss files
+// are measured by parser_throughput instead of its own sheets
+// g++ -std=c++11 -O2 -fPIC -Isrc -Iinclude test/bench.cpp lib/libsass.a -ldl -lpthread -o bench
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <random>
+#include <vector>
+#include "sass/context.h"
+#include "sass.hpp"
+#include "file.hpp"
+#include "context.hpp"
+#include "sass_context.hpp"
+#include "parser.hpp"
+#include "prelexer.hpp"
+#include "char_scan.hpp"
+#include "number_format.hpp"
+#include "base64vlq.hpp"
+#include "subset_map.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+// milliseconds since start
+long long ms_since(Clock::time_point start)
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+// compiles scss and returns the milliseconds it took
+// or -1 and prints the error if it did not compile
+long long compile(const std::string& scss)
+{
+  struct Sass_Data_Context* data_ctx = sass_make_data_context(sass_copy_c_string(scss.c_str()));
+  struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+  sass_option_set_output_style(sass_context_get_options(ctx), SASS_STYLE_COMPRESSED);
+  Clock::time_point start = Clock::now();
+  int status = sass_compile_data_context(data_ctx);
+  long long ms = ms_since(start);
+  if (status) std::cout << sass_context_get_error_message(ctx);
+  sass_delete_data_context(data_ctx);
+  return status ? -1 : ms;
+}
+
+// map-get and map-has-key on a map of 200 entries,
+// `hits` of every 100 probes are found
+void map_lookup()
+{
+  for (int hits : { 0, 50, 90, 100 }) {
+    std::stringstream scss;
+    scss << "$map: ();\n";
+    scss << "@for $i from 1 through 200 { $map: map-merge($map, (key-#{$i}: $i)); }\n";
+    scss << "$found: 0;\n";
+    scss << "@for $i from 0 to 20000 {\n";
+    scss << "  $key: if($i % 100 < " << hits << ", key-#{$i % 200 + 1}, nope-#{$i});\n";
+    scss << "  @if map-has-key($map, $key) { $found: $found + map-get($map, $key) * 0 + 1; }\n";
+    scss << "}\n";
+    scss << "a { found: $found; }\n";
+    std::cout << "  hits " << hits << "%: " << compile(scss.str()) << "ms" << std::endl;
+  }
+}
+
+// format_number with typical css values
+void number_format()
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> small(-2000, 2000);
+  std::vector<double> values;
+  for (int i = 0; i < 500000; ++i) values.push_back(small(rng) / (i % 2 ? 100.0 : 3.0));
+  size_t bytes = 0;
+  Clock::time_point start = Clock::now();
+  for (double value : values) bytes += Sass::format_number(value, 5, false).size();
+  std::cout << "  " << values.size() << " numbers: " << ms_since(start) << "ms (" << bytes << " bytes)" << std::endl;
+}
+
+// Base64VLQ on mostly small deltas like in source map mappings
+void base64vlq()
+{
+  std::mt19937 rng(42);
+  std::geometric_distribution<int> size(0.2);
+  std::vector<int> values;
+  for (int i = 0; i < 4000000; ++i) values.push_back(i % 3 ? size(rng) : -size(rng));
+  Sass::Base64VLQ vlq;
+  std::string mappings(values.size() * Sass::Base64VLQ::MAX_LENGTH, 0);
+  Clock::time_point start = Clock::now();
+  mappings.resize(vlq.encode(values.data(), values.size(), &mappings[0]) - mappings.data());
+  std::cout << "  " << values.size() << " numbers: " << ms_since(start) << "ms (" << mappings.size() << " bytes)" << std::endl;
+}
+
+// compound selector like keys (`.c3`, `:hover`, `a` ...)
+std::vector<std::string> compound(std::mt19937& rng, size_t classes)
+{
+  static const char* pseudos[] = { ":hover", ":focus", ":active", ":first-child", "::before" };
+  static const char* types[] = { "a", "div", "li", "input", "span" };
+  std::uniform_int_distribution<size_t> cls(0, classes - 1), pick(0, 4), size(1, 3);
+  std::vector<std::string> keys;
+  if (pick(rng) == 0) keys.push_back(types[pick(rng)]);
+  for (size_t i = size(rng); i > 0; --i) keys.push_back(".c" + std::to_string(cls(rng)));
+  if (pick(rng) < 2) keys.push_back(pseudos[pick(rng)]);
+  return keys;
+}
+
+// lookups of compound selectors in a subset map of 20000 extenders
+void subset_map()
+{
+  std::mt19937 rng(42);
+  size_t extenders = 20000, classes = extenders / 2;
+  Sass::Subset_Map<std::string, size_t> map;
+  for (size_t i = 0; i < extenders; ++i) map.put(compound(rng, classes), i);
+  std::vector<std::vector<std::string> > lookups;
+  for (size_t i = 0; i < 100000; ++i) {
+    lookups.push_back(compound(rng, classes));
+    // make sure we also get many hits
+    if (i % 2) lookups.back().push_back(".c" + std::to_string(i % classes));
+  }
+  size_t found = 0;
+  Clock::time_point start = Clock::now();
+  for (const std::vector<std::string>& keys : lookups) found += map.get_v(keys).size();
+  std::cout << "  " << lookups.size() << " lookups: " << ms_since(start) << "ms (" << found << " found)" << std::endl;
+}
+
+// framework like sheet: settings, functions, mixins, control
+// directives, nested rules with many declarations and media
+std::string source(int components)
+{
+  std::stringstream scss;
+  scss << "// settings\n";
+  for (int i = 0; i < 40; ++i) {
+    scss << "$color-" << i << ": rgba(" << i << ", 10, 20, .5) !default;\n";
+    scss << "$spacer-" << i << ": " << i * 4 << "px !default;\n";
+  }
+  scss << "$breakpoints: (sm: 576px, md: 768px, lg: 992px, xl: 1200px);\n";
+  scss << "@function rem($px, $base: 16px) { @return $px / $base * 1rem; }\n";
+  scss << "@function tint($color, $amount) {\n";
+  scss << "  @if $amount > 0 { @return mix(white, $color, $amount); }\n";
+  scss << "  @else { @return mix(black, $color, -$amount); }\n";
+  scss << "}\n";
+  scss << "@mixin respond($name) {\n";
+  scss << "  $min: map-get($breakpoints, $name);\n";
+  scss << "  @if $min { @media (min-width: $min) { @content; } } @else { @content; }\n";
+  scss << "}\n";
+  scss << "@mixin button-variant($bg, $border: darken($bg, 5%)) {\n";
+  scss << "  color: #fff; background-color: $bg; border-color: $border;\n";
+  scss << "  &:hover { background-color: darken($bg, 7.5%); }\n";
+  scss << "}\n";
+  scss << "%clearfix { &::after { display: block; clear: both; content: \"\"; } }\n";
+  for (int i = 0; i < components; ++i) {
+    scss << "/* component " << i << " */\n";
+    scss << ".component-" << i << " {\n";
+    scss << "  @extend %clearfix;\n";
+    scss << "  position: relative;\n";
+    scss << "  display: flex;\n";
+    scss << "  margin: 0 auto $spacer-" << (i % 40) << ";\n";
+    scss << "  padding: rem(" << (i % 24) << "px) rem(12px);\n";
+    scss << "  font: { family: $font-family; size: rem(14px); weight: 400; }\n";
+    scss << "  color: $color-" << (i % 40) << "; // text\n";
+    scss << "  border: 1px solid tint($color-" << (i % 40) << ", 20%);\n";
+    scss << "  transition: color .15s ease-in-out, background-color .15s ease-in-out;\n";
+    scss << "  > .item, + .sibling ~ .other { flex: 1 1 auto; min-width: 0; }\n";
+    scss << "  &__title { margin-bottom: .5rem; line-height: 1.2; }\n";
+    scss << "  &--primary { @include button-variant($color-" << (i % 40) << "); }\n";
+    scss << "  @include respond(md) { width: percentage(" << (i % 12 + 1) << " / 12); }\n";
+    scss << "  @media print { display: none !important; }\n";
+    scss << "  #{&}-icon, a[href^=\"http\"]:not(.internal) { background: url(\"icons/" << i << ".svg\") no-repeat; }\n";
+    scss << "}\n";
+    if (i % 10 == 0) {
+      scss << "@each $name, $size in $breakpoints {\n";
+      scss << "  .col-" << i << "-#{$name} { @for $j from 1 through 3 { &-#{$j} { width: $j * 10%; } } }\n";
+      scss << "}\n";
+    }
+  }
+  return scss.str();
+}
+
+// milliseconds to parse the sheet runs times (no evaluation
+// or output), or -1 if a run gives an empty tree
+double parse(const std::string& scss, int runs)
+{
+  double ms = 0;
+  for (int i = 0; i < runs; ++i) {
+    struct Sass_Data_Context* data_ctx = sass_make_data_context(sass_copy_c_string("a{}"));
+    Sass::Context* ctx = new Sass::Data_Context(*data_ctx);
+    Clock::time_point start = Clock::now();
+    // same setup as Context::register_resource
+    Sass::Parser parser(Sass::Parser::from_c_str(scss.c_str(), *ctx, Sass::ParserState("[BENCH]")));
+    Sass::Line_Index lines(parser.position, parser.end);
+    parser.lines = &lines;
+    Sass::Block* root = parser.parse();
+    ms += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    bool empty = !root || root->length() == 0;
+    delete ctx;
+    sass_delete_data_context(data_ctx);
+    if (empty) return -1;
+  }
+  return ms;
+}
+
+void parse_sheet(const std::string& name, const std::string& scss, int runs)
+{
+  double ms = parse(scss, runs);
+  if (ms < 0) {
+    std::cout << "  " << name << ": empty tree" << std::endl;
+    return;
+  }
+  double mb = scss.size() * double(runs) / (1024 * 1024);
+  std::cout << "  " << name << ": " << scss.size() / 1024 << "KB, "
+            << (int) (mb / (ms / 1000) * 10) / 10.0 << "MB/s" << std::endl;
+}
+
+// scss files given on the command line; imports are not
+// resolved, so they should be self-contained
+std::vector<std::string> sheets;
+
+// the parser alone in MB/s
+void parser_throughput()
+{
+  for (const std::string& path : sheets) {
+    std::ifstream file(path.c_str());
+    std::stringstream scss;
+    scss << file.rdbuf();
+    parse_sheet(path, scss.str(), 20);
+  }
+  if (!sheets.empty()) return;
+  parse_sheet("generated (small)", source(100), 100);
+  parse_sheet("generated (large)", source(10000), 3);
+}
+
+const char* scope_until_paren(const char* src)
+{
+  return Sass::Prelexer::skip_over_scopes< Sass::Prelexer::exactly<'('>, Sass::Prelexer::exactly<')'> >(src);
+}
+
+// MB/s of matching src runs times
+double match(Sass::Prelexer::prelexer mx, const std::string& src, int runs)
+{
+  const char* end = 0;
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < runs; ++i) end = mx(src.c_str());
+  double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  if (!end) return 0;
+  return src.size() * double(runs) / (1024 * 1024) / (ms / 1000);
+}
+
+// the prelexer matchers using char_scan with every implementation
+// the cpu supports, on typical content of vendor sheets and imports
+void char_scan()
+{
+  using namespace Sass::Prelexer;
+  std::string uri("\"data:image/svg+xml;base64,");
+  for (int i = 0; i < 4000; ++i) uri += "PHN2ZyB4bWxucz0iaHR0cDovL3d3dy53My5vcmcvMjAwMC9zdmci";
+  uri += "\"";
+  std::string license("/*!\n");
+  for (int i = 0; i < 2000; ++i) license += " * Permission is hereby granted, free of charge, to any person obtaining a copy\n";
+  license += " */";
+  std::string line("//");
+  for (int i = 0; i < 2000; ++i) line += " minified sources may end with a very long line comment";
+  std::string lines;
+  for (int i = 0; i < 2000; ++i) lines += "    // settings for the grid, override them before the import of this file\n";
+  std::string indent(256, ' ');
+  for (int i = 0; i < 64; ++i) indent += "\n" + std::string(48, ' ') + "\t";
+  std::string scope;
+  for (int i = 0; i < 2000; ++i) scope += "\"a string (with parens) in a function call\", ";
+  scope += "x)";
+
+  struct Sample { const char* name; prelexer mx; std::string src; };
+  const Sample samples[] = {
+    { "spaces", spaces, indent },
+    { "line_comment", line_comment, line },
+    { "block_comment", block_comment, license },
+    { "optional_css_whitespace", optional_css_whitespace, lines },
+    { "css_comments", css_comments, license + "\n" + lines },
+    { "quoted_string", quoted_string, uri },
+    { "skip_over_scopes", scope_until_paren, scope }
+  };
+  const char* impl_names[] = { "scalar", "sse2", "avx2" };
+  Sass::Char_Scan_Impl selected = Sass::char_scan_impl();
+  for (const Sample& sample : samples) {
+    std::cout << "  " << sample.name << ":";
+    for (int impl = Sass::SCAN_SCALAR; impl <= Sass::SCAN_AVX2; ++impl) {
+      if (!Sass::use_char_scan((Sass::Char_Scan_Impl) impl)) continue;
+      std::cout << " " << impl_names[impl] << " " << (int) match(sample.mx, sample.src, 200) << "MB/s";
+    }
+    std::cout << std::endl;
+  }
+  Sass::use_char_scan(selected);
+}
+
+// read_file and read_resource on a huge generated partial,
+// read_resource touches every page like the parser does
+void read_resource()
+{
+  std::string path("bench_read_resource.scss");
+  size_t size = 64 * 1024 * 1024;
+  {
+    std::string content;
+    while (content.size() < size) content += ".rule { color: red; } // comment\n";
+    content.resize(size);
+    std::ofstream file(path.c_str(), std::ios::binary);
+    file << content;
+  }
+  Clock::time_point start = Clock::now();
+  char* contents = Sass::File::read_file(path);
+  std::cout << "  read_file:     " << ms_since(start) << "ms" << std::endl;
+  free(contents);
+  start = Clock::now();
+  Sass::Resource res(Sass::File::read_resource(path));
+  size_t length = res.contents ? std::strlen(res.contents) : 0;
+  std::cout << "  read_resource: " << ms_since(start) << "ms (" << length << " bytes)" << std::endl;
+  Sass::File::free_resource(res);
+  unlink(path.c_str());
+}
+
+struct Bench {
+  const char* name;
+  void (*run)();
+};
+
+const Bench benches[] = {
+  { "map_lookup", map_lookup },
+  { "number_format", number_format },
+  { "base64vlq", base64vlq },
+  { "subset_map", subset_map },
+  { "parser_throughput", parser_throughput },
+  { "char_scan", char_scan },
+  { "read_resource", read_resource }
+};
+
+bool is_sheet(const std::string& arg)
+{
+  return arg.size() > 5 && arg.compare(arg.size() - 5, 5, ".scss") == 0;
+}
+
+int main(int argc, char** argv)
+{
+  for (int i = 1; i < argc; ++i) {
+    if (is_sheet(argv[i])) sheets.push_back(argv[i]);
+  }
+  for (const Bench& bench : benches) {
+    bool selected = argc < 2;
+    for (int i = 1; i < argc; ++i) {
+      if (std::string(argv[i]) == bench.name) selected = true;
+    }
+    if (bench.run == parser_throughput && !sheets.empty()) selected = true;
+    if (!selected) continue;
+    std::cout << bench.name << std::endl;
+    bench.run();
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+// checks Base64VLQ::encode with fixed values, also for the
+// buffer and batch versions; exits with 1 if any check fails
+// g++ -std=c++11 -Isrc test/test_base64vlq.cpp lib/libsass.a -ldl -o base64vlq
+#include <string>
+#include <vector>
+#include <climits>
+#include <iostream>
+#include "base64vlq.hpp"
+
+using namespace Sass;
+
+struct Spec {
+  int value;
+  const char* expected;
+};
+
+const Spec specs[] = {
+  { 0, "A" },
+  { 1, "C" },
+  { -1, "D" },
+  { 15, "e" },
+  { -15, "f" },
+  // continuation starts at 16
+  { 16, "gB" },
+  { -16, "hB" },
+  { 511, "+f" },
+  { 512, "ggB" },
+  { -1000, "x+B" },
+  { 123456, "gkxH" },
+  // extremes need MAX_LENGTH chars
+  { INT_MAX, "+/////D" },
+  { INT_MIN, "hgggggE" }
+};
+
+// number of failed checks
+size_t failures = 0;
+
+void check(const std::string& expected, const std::string& actual, const std::string& what)
+{
+  if (expected == actual) return;
+  std::cout << what << ": expected \"" << expected << "\" but got \"" << actual << "\"" << std::endl;
+  ++ failures;
+}
+
+int main()
+{
+  Base64VLQ vlq;
+  char buffer[Base64VLQ::MAX_LENGTH];
+  std::vector<int> values;
+  std::string joined;
+
+  for (const Spec& spec : specs) {
+    std::string what("encode(" + std::to_string(spec.value) + ")");
+    check(spec.expected, vlq.encode(spec.value), what);
+    check(spec.expected, std::string(buffer, vlq.encode(spec.value, buffer)), "buffered " + what);
+    values.push_back(spec.value);
+    joined += spec.expected;
+  }
+
+  // the batch version writes the numbers one after another
+  std::string batch(values.size() * Base64VLQ::MAX_LENGTH, 0);
+  batch.resize(vlq.encode(values.data(), values.size(), &batch[0]) - batch.data());
+  check(joined, batch, "batch encode");
+  check("", std::string(buffer, vlq.encode(values.data(), 0, buffer)), "empty batch");
+
+  std::cout << failures << " failures" << std::endl;
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+// checks the prelexer matchers using char_scan with fixed inputs and
+// every implementation the cpu supports, also with the inputs ending
+// right before an inaccessible page; exits with 1 if any check fails
+// g++ -std=c++11 -Isrc test/test_char_scan.cpp lib/libsass.a -ldl -o char_scan
+#include <string>
+#include <iostream>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "char_scan.hpp"
+#include "prelexer.hpp"
+
+using namespace Sass;
+using namespace Sass::Prelexer;
+
+const char* scope_until_paren(const char* src) {
+  return skip_over_scopes< exactly<'('>, exactly<')'> >(src);
+}
+
+// scans for a char that is in none of the inputs
+const char* chars_xyz(const char* src) { return scan_chars(src, 'x', 'y', 'z'); }
+const char* chars_star(const char* src) { return scan_chars(src, '*', '*', '*'); }
+
+struct Spec {
+  const char* name;
+  prelexer mx;
+  std::string src;
+  // length of the match or -1 if it fails
+  int expected;
+};
+
+// long runs make sure every implementation gets past
+// its first block of 16 or 32 chars before the match ends
+const std::string pad(40, ' ');
+const std::string text(40, 'a');
+
+const std::vector<Spec> specs = {
+  { "spaces", spaces, " \t\n\r\fx", 5 },
+  { "spaces", spaces, "x ", -1 },
+  { "spaces", spaces, "", -1 },
+  { "line_comment", line_comment, "// a comment\nx", 12 },
+  { "line_comment", line_comment, "// a comment", 12 },
+  { "line_comment", line_comment, "/ no comment", -1 },
+  { "block_comment", block_comment, "/* a */ b", 7 },
+  { "block_comment", block_comment, "/* a **/", 8 },
+  { "block_comment", block_comment, "/*/ b", -1 },
+  { "block_comment", block_comment, "/* unterminated", -1 },
+  { "optional_css_whitespace", optional_css_whitespace, "  // a\n  x", 9 },
+  { "optional_css_whitespace", optional_css_whitespace, "/* a */", 0 },
+  { "optional_css_whitespace", optional_css_whitespace, "x", 0 },
+  { "css_comments", css_comments, " /* a */ // b\n x", 15 },
+  { "css_comments", css_comments, "x", -1 },
+  { "quoted_string", quoted_string, "\"a b\" c", 5 },
+  { "quoted_string", quoted_string, "'a \"b\" c' d", 9 },
+  { "quoted_string", quoted_string, "\"a \\\" b\" c", 8 },
+  { "quoted_string", quoted_string, "\"a #{\"}\"} b\" c", 12 },
+  { "quoted_string", quoted_string, "\"unterminated", -1 },
+  // raw newlines are taken as they are
+  { "quoted_string", quoted_string, "\"a\nb\"", 5 },
+  { "skip_over_scopes", scope_until_paren, "a (b) c) d", 8 },
+  { "skip_over_scopes", scope_until_paren, "\")\" ')' \\) ) d", 12 },
+  { "skip_over_scopes", scope_until_paren, "a (b c", -1 },
+  { "scan_chars", chars_xyz, "abc", 3 },
+  { "scan_chars", chars_star, "/ a * b", 4 },
+  { "scan_spaces", scan_spaces, " \t\n\r\fx", 5 },
+  { "scan_spaces", scan_spaces, "x", 0 },
+  { "spaces", spaces, pad + "x", 40 },
+  { "line_comment", line_comment, "//" + text + "\nx", 42 },
+  { "block_comment", block_comment, "/*" + text + "*/x", 44 },
+  { "block_comment", block_comment, "/*" + text, -1 },
+  { "css_comments", css_comments, pad + "/*" + pad + "*/" + pad + "x", 124 },
+  { "quoted_string", quoted_string, "\"" + text + "\"x", 42 },
+  // end marks and escapes across the block boundaries
+  { "block_comment", block_comment, "/*" + std::string(13, 'a') + "*/x", 17 },
+  { "block_comment", block_comment, "/*" + std::string(29, 'a') + "*/x", 33 },
+  { "quoted_string", quoted_string, "\"" + std::string(14, 'a') + "\\\"a\"x", 19 },
+  { "quoted_string", quoted_string, "\"" + std::string(30, 'a') + "\\\"a\"x", 35 },
+  { "skip_over_scopes", scope_until_paren, text + "(" + text + ")" + text + ")x", 123 },
+  { "scan_chars", chars_xyz, text, 40 },
+  { "scan_spaces", scan_spaces, pad + "x", 40 },
+};
+
+const char* impl_names[] = { "scalar", "sse2", "avx2" };
+
+// number of failed checks
+size_t failures = 0;
+
+void check(const Spec& spec, const char* src, const char* where)
+{
+  const char* end = spec.mx(src);
+  int actual = end ? int(end - src) : -1;
+  if (actual == spec.expected) return;
+  std::cout << spec.name << " (" << impl_names[char_scan_impl()] << where << ") of \""
+            << src << "\": expected " << spec.expected << " but got " << actual << std::endl;
+  ++ failures;
+}
+
+// copies src right before an inaccessible page,
+// so any read past the terminator would crash
+void check_at_page_end(const Spec& spec, char* guarded)
+{
+  char* copy = guarded - spec.src.size() - 1;
+  std::copy(spec.src.begin(), spec.src.end(), copy);
+  copy[spec.src.size()] = 0;
+  check(spec, copy, " at page end");
+}
+
+int main()
+{
+  size_t page = sysconf(_SC_PAGESIZE);
+  char* mem = (char*) mmap(0, page * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED) {
+    std::cout << "could not map a guarded page" << std::endl;
+    return 1;
+  }
+  mprotect(mem + page, page, PROT_NONE);
+
+  Char_Scan_Impl selected = char_scan_impl();
+  std::cout << "selected " << impl_names[selected] << std::endl;
+  for (int impl = SCAN_SCALAR; impl <= SCAN_AVX2; ++impl) {
+    if (!use_char_scan((Char_Scan_Impl) impl)) continue;
+    for (const Spec& spec : specs) {
+      check(spec, spec.src.c_str(), "");
+      check_at_page_end(spec, mem + page);
+    }
+  }
+  use_char_scan(selected);
+  munmap(mem, page * 2);
+
+  std::cout << failures << " failures" << std::endl;
+  return failures ? 1 : 0;
+}
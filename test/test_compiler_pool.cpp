@@ -0,0 +1,122 @@
+// compiles file and data contexts through one compiler pool, also from
+// several threads at once, and compares them with plain compilations
+// g++ -Iinclude test/test_compiler_pool.cpp lib/libsass.a -ldl -lpthread -o compiler_pool
+#include <string>
+#include <vector>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include "sass/context.h"
+
+std::string dir;
+
+void write(const std::string& path, const std::string& content)
+{
+  std::ofstream(dir + "/" + path) << content;
+}
+
+std::string result(int status, struct Sass_Context* ctx)
+{
+  return status ? sass_context_get_error_message(ctx) : sass_context_get_output_string(ctx);
+}
+
+void setup(struct Sass_Options* options, int style)
+{
+  sass_option_set_output_style(options, (enum Sass_Output_Style) style);
+  sass_option_set_include_path(options, (dir + "/lib").c_str());
+}
+
+std::string compile_file(struct Sass_Compiler_Pool* pool, const std::string& file, int style)
+{
+  struct Sass_File_Context* file_ctx = sass_make_file_context((dir + "/" + file).c_str());
+  struct Sass_Context* ctx = sass_file_context_get_context(file_ctx);
+  setup(sass_context_get_options(ctx), style);
+  int status = pool ? sass_compiler_pool_compile_file(pool, file_ctx) : sass_compile_file_context(file_ctx);
+  std::string css(result(status, ctx));
+  sass_delete_file_context(file_ctx);
+  return css;
+}
+
+std::string compile_data(struct Sass_Compiler_Pool* pool, const std::string& source, int style)
+{
+  struct Sass_Data_Context* data_ctx = sass_make_data_context(sass_copy_c_string(source.c_str()));
+  struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+  setup(sass_context_get_options(ctx), style);
+  int status = pool ? sass_compiler_pool_compile_data(pool, data_ctx) : sass_compile_data_context(data_ctx);
+  std::string css(result(status, ctx));
+  sass_delete_data_context(data_ctx);
+  return css;
+}
+
+const char* files[] = { "one.scss", "two.scss", "broken.scss", 0 };
+const char* sources[] = {
+  "@import 'colors', 'mixins';\n.d { @include box(3px); color: darken($brand, 10%); }\n",
+  "@import 'mixins';\n.e { @include box(1px / 2); }\n",
+  ".f { width: 10px + 2em; }\n",
+  0
+};
+
+// compiles everything and counts the results that differ from expected
+size_t run(struct Sass_Compiler_Pool* pool, const std::vector<std::string>& expected)
+{
+  size_t mismatches = 0, n = 0;
+  for (int style = 0; style < 4; ++style) {
+    for (const char** file = files; *file; ++file) {
+      if (compile_file(pool, *file, style) != expected[n++] && mismatches++ == 0) {
+        std::cout << "mismatch for " << *file << " (style " << style << ")" << std::endl;
+      }
+    }
+    for (const char** source = sources; *source; ++source) {
+      if (compile_data(pool, *source, style) != expected[n++] && mismatches++ == 0) {
+        std::cout << "mismatch for data " << (source - sources) << " (style " << style << ")" << std::endl;
+      }
+    }
+  }
+  return mismatches;
+}
+
+int main()
+{
+  char tmpl[] = "/tmp/compiler_pool_XXXXXX";
+  if (!mkdtemp(tmpl)) return 1;
+  dir = tmpl;
+  mkdir((dir + "/lib").c_str(), 0755);
+  write("lib/_colors.scss", "$brand: #3366cc !default;\n%muted { color: gray; }\n");
+  write("lib/_mixins.scss", "@mixin box($w) { border: $w solid; padding: -$w; margin: 10px/8px; }\n");
+  write("one.scss", "@import 'colors';\n.a { @extend %muted; background: $brand; }\n.b { @import 'mixins'; @include box(2px); }\n");
+  write("two.scss", "$brand: red;\n@import 'colors', 'mixins';\n.c { color: $brand; @include box(1em); }\n");
+  write("broken.scss", "@import 'mixins';\n.x { @include missing; }\n");
+
+  std::vector<std::string> expected;
+  for (int style = 0; style < 4; ++style) {
+    for (const char** file = files; *file; ++file) expected.push_back(compile_file(0, *file, style));
+    for (const char** source = sources; *source; ++source) expected.push_back(compile_data(0, *source, style));
+  }
+
+  struct Sass_Compiler_Pool* pool = sass_make_compiler_pool(sass_make_options());
+  if (pool == 0) return 1;
+
+  // compile everything twice, the second time with cached imports
+  size_t mismatches = run(pool, expected) + run(pool, expected);
+
+  // then share the pool between threads
+  std::vector<size_t> counts(4, 0);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    workers.push_back(std::thread([&, i] { counts[i] = run(pool, expected); }));
+  }
+  for (size_t i = 0; i < workers.size(); ++i) workers[i].join();
+  for (size_t i = 0; i < counts.size(); ++i) mismatches += counts[i];
+
+  sass_delete_compiler_pool(pool);
+
+  const char* paths[] = { "lib/_colors.scss", "lib/_mixins.scss", "one.scss", "two.scss", "broken.scss", "lib", 0 };
+  for (const char** path = paths; *path; ++path) remove((dir + "/" + *path).c_str());
+  remove(dir.c_str());
+
+  std::cout << mismatches << " mismatches" << std::endl;
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,72 @@
+// checks the results of map-get, map-has-key and map-remove;
+// prints every wrong output and exits with 1 if there is any
+// (test/bench.cpp measures the lookups)
+// g++ -Iinclude test/test_map_lookup.cpp lib/libsass.a -ldl -o map_lookup
+#include <string>
+#include <sstream>
+#include <iostream>
+#include "sass/context.h"
+
+const int keys = 200;
+const int probes = 20000;
+
+// probe a map of `keys` entries, `hits` of every 100 probes are found
+std::string source(int hits)
+{
+  std::stringstream scss;
+  scss << "$map: ();\n";
+  scss << "@for $i from 1 through " << keys << " {\n";
+  scss << "  $map: map-merge($map, (key-#{$i}: $i));\n";
+  scss << "}\n";
+  scss << "$found: 0;\n";
+  scss << "$missed: 0;\n";
+  scss << "@for $i from 0 to " << probes << " {\n";
+  scss << "  $key: if($i % 100 < " << hits << ", key-#{$i % " << keys << " + 1}, nope-#{$i});\n";
+  scss << "  @if map-has-key($map, $key) { $found: $found + map-get($map, $key) * 0 + 1; }\n";
+  scss << "  @else if map-get($map, $key) == null { $missed: $missed + 1; }\n";
+  scss << "}\n";
+  scss << "$rest: map-remove($map, key-1, key-2, nope);\n";
+  scss << "a { found: $found; missed: $missed; rest: length($rest); }\n";
+  return scss.str();
+}
+
+std::string expected(int hits)
+{
+  int found = (probes / 100) * hits;
+  std::stringstream css;
+  css << "a{found:" << found << ";missed:" << (probes - found) << ";rest:" << (keys - 2) << "}\n";
+  return css.str();
+}
+
+// compiles scss, returns whether it gives css
+bool compile(const std::string& scss, const std::string& css, const char* label)
+{
+  struct Sass_Data_Context* data_ctx = sass_make_data_context(sass_copy_c_string(scss.c_str()));
+  struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+  struct Sass_Options* options = sass_context_get_options(ctx);
+  sass_option_set_output_style(options, SASS_STYLE_COMPRESSED);
+  int status = sass_compile_data_context(data_ctx);
+
+  std::string actual(status ? sass_context_get_error_message(ctx) : sass_context_get_output_string(ctx));
+  bool ok = actual == css;
+  if (!ok) std::cout << label << ": expected \"" << css << "\" but got \"" << actual << "\"" << std::endl;
+  sass_delete_data_context(data_ctx);
+  return ok;
+}
+
+int main()
+{
+  size_t failures = 0;
+  for (int hits : { 0, 50, 90, 100 }) {
+    std::string label("hits " + std::to_string(hits) + "%");
+    if (!compile(source(hits), expected(hits), label.c_str())) ++ failures;
+  }
+  // map-remove matches keys as == does, also with units
+  if (!compile("a { b: inspect(map-remove((2px: a, 2: b, c: d), 2)); }",
+               "a{b:(c: d)}\n", "remove 2")) ++ failures;
+  if (!compile("a { b: inspect(map-remove((2: a, c: d), 2px, e)); }",
+               "a{b:(c: d)}\n", "remove 2px")) ++ failures;
+  if (!compile("a { b: inspect(map-remove((2: a, c: d), e)); }",
+               "a{b:(2: a, c: d)}\n", "remove nothing")) ++ failures;
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,106 @@
+// checks format_number and format_fixed with fixed values, including
+// the quirks of the former stream output that must be kept;
+// prints every mismatch and exits with 1 if there is any
+// g++ -std=c++11 -Isrc test/test_number_format.cpp lib/libsass.a -ldl -o number_format
+#include <cmath>
+#include <string>
+#include <iostream>
+#include "number_format.hpp"
+
+using namespace Sass;
+
+struct Spec {
+  double value;
+  int precision;
+  bool strip_zero;
+  const char* expected;
+};
+
+const Spec specs[] = {
+  { 0, 5, false, "0" },
+  { -0.0, 5, false, "0" },
+  { 1, 5, false, "1" },
+  { -1.5, 5, false, "-1.5" },
+  { 0.5, 5, false, "0.5" },
+  { 0.5, 5, true, ".5" },
+  { -0.5, 5, true, "-.5" },
+  { 1.0 / 3, 5, false, "0.33333" },
+  { 1.0 / 3, 10, false, "0.3333333333" },
+  { 2.0 / 3, 5, false, "0.66667" },
+  { 2.0 / 3, 5, true, ".66667" },
+  { 12.3456, 3, true, "12.346" },
+  { 1e-5, 5, false, "0.00001" },
+  { 1e-6, 10, false, "0.000001" },
+  // rounds to zero without a sign
+  { 1e-6, 5, false, "0" },
+  { -1e-6, 5, false, "0" },
+  { -0.04, 1, false, "0" },
+  { 5e-324, 5, false, "0" },
+  // exact ties round to even, others as they are stored
+  { 2.5, 0, false, "2" },
+  { 3.5, 0, false, "4" },
+  { 0.125, 2, false, "0.12" },
+  { 99.999995, 5, false, "99.99999" },
+  // the stream output looked at 12 significant digits first
+  { 9.99999, 4, false, "10.0" },
+  { 1.005, 2, false, "1.0" },
+  { 123456789012.34, 5, false, "123456789012" },
+  { 0.1, 19, false, "0.1" },
+  { 1e12, 5, false, "1000000000000" },
+  // out of range of format_fixed, uses the stream fallback
+  { 1e21, 5, false, "1000000000000000000000" },
+  { -1e21, 5, false, "-1000000000000000000000" },
+  { 0.1, 20, false, "0.1" }
+};
+
+// number of failed checks
+size_t failures = 0;
+
+void check(const std::string& expected, const std::string& actual, const std::string& what)
+{
+  if (expected == actual) return;
+  std::cout << what << ": expected \"" << expected << "\" but got \"" << actual << "\"" << std::endl;
+  ++ failures;
+}
+
+// formats into a buffer, empty if format_number returns 0
+std::string buffered(double value, int precision, bool strip_zero)
+{
+  char buffer[NUMBER_BUFFER_SIZE];
+  return std::string(buffer, format_number(value, precision, strip_zero, buffer));
+}
+
+std::string fixed(double value, int digits)
+{
+  char buffer[FIXED_BUFFER_SIZE];
+  return std::string(buffer, format_fixed(value, digits, buffer));
+}
+
+int main()
+{
+  for (const Spec& spec : specs) {
+    std::string what(std::to_string(spec.value) + " with precision " + std::to_string(spec.precision));
+    check(spec.expected, format_number(spec.value, spec.precision, spec.strip_zero), what);
+  }
+
+  // the buffer version leaves the fallback to the caller
+  check("1.5", buffered(1.5, 5, false), "buffered 1.5");
+  check(".5", buffered(0.5, 5, true), "buffered .5");
+  check("", buffered(0.1, 20, false), "buffered precision 20");
+  check("", buffered(1e21, 5, false), "buffered 1e21");
+  check("", buffered(NAN, 5, false), "buffered nan");
+  check("", buffered(INFINITY, 5, false), "buffered inf");
+  check("", buffered(-INFINITY, 5, false), "buffered -inf");
+
+  // same as printf("%.*f") in the C locale, or empty if out of range
+  check("1.2", fixed(1.25, 1), "fixed 1.25");
+  check("0.1", fixed(0.05, 1), "fixed 0.05");
+  check("-0", fixed(-0.5, 0), "fixed -0.5");
+  check("0.1000000000000000056", fixed(0.1, 19), "fixed 19 digits");
+  check("", fixed(0.1, 20), "fixed 20 digits");
+  check("10000000000000000000", fixed(1e19, 0), "fixed 1e19");
+  check("", fixed(1e20, 0), "fixed 1e20");
+
+  std::cout << failures << " failures" << std::endl;
+  return failures ? 1 : 0;
+}
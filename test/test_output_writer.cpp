@@ -0,0 +1,81 @@
+// compiles the same sources with and without an output writer
+// the streamed output must match and arrive in several chunks;
+// prints every mismatch and exits with 1 if there is any
+// g++ -Iinclude test/test_output_writer.cpp lib/libsass.a -ldl -o output_writer
+#include <string>
+#include <sstream>
+#include <iostream>
+#include "sass/context.h"
+
+struct Sink {
+  std::string output;
+  size_t chunks;
+};
+
+void write(const char* data, size_t length, void* cookie)
+{
+  Sink* sink = static_cast<Sink*>(cookie);
+  sink->output.append(data, length);
+  sink->chunks += 1;
+}
+
+// hoisted comment and import, unicode in the first chunk
+// or after it (late), where it still has to end up on top
+std::string source(int rules, bool late)
+{
+  std::stringstream scss;
+  scss << "/* header */\n";
+  if (!late) scss << ".first { content: \"\xC3\xA9\"; }\n";
+  if (!late) scss << "@import url(foo.css);\n";
+  scss << "@for $i from 1 through " << rules << " {\n";
+  scss << "  .rule-#{$i} { width: $i * 1px; /* comment */ }\n";
+  scss << "}\n";
+  if (late) scss << ".last { content: unquote(\"\\e9\"); }\n";
+  if (late) scss << "@import url(foo.css);\n";
+  return scss.str();
+}
+
+// returns the output string or the error message
+std::string compile(const std::string& scss, int style, bool embed, Sink* sink)
+{
+  struct Sass_Data_Context* data_ctx = sass_make_data_context(sass_copy_c_string(scss.c_str()));
+  struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+  struct Sass_Options* options = sass_context_get_options(ctx);
+  sass_option_set_output_style(options, (enum Sass_Output_Style) style);
+  if (embed) {
+    sass_option_set_source_map_file(options, "out.css.map");
+    sass_option_set_source_map_embed(options, true);
+    sass_option_set_source_map_contents(options, true);
+  }
+  if (sink) {
+    sass_option_set_output_writer(options, write);
+    sass_option_set_output_writer_cookie(options, sink);
+  }
+  int status = sass_compile_data_context(data_ctx);
+  std::string output(status ? sass_context_get_error_message(ctx) : sass_context_get_output_string(ctx));
+  sass_delete_data_context(data_ctx);
+  return output;
+}
+
+int main()
+{
+  size_t failures = 0;
+  for (int rules : { 10, 20000 }) for (int late = 0; late < 2; ++ late) {
+    std::string scss(source(rules, late));
+    for (int style = 0; style < 4; ++ style) {
+      for (int embed = 0; embed < 2; ++ embed) {
+        Sink sink = { "", 0 };
+        std::string expected(compile(scss, style, embed, 0));
+        std::string streamed(compile(scss, style, embed, &sink));
+        // small outputs are written at the end, late
+        // unicode or imports hold back the first chunk
+        bool ok = streamed.empty() && sink.output == expected &&
+                  (rules == 10 || late || sink.chunks > 2);
+        if (!ok) ++ failures;
+        std::cout << (ok ? "" : "FAILED ") << rules << " rules" << (late ? " (late)" : "") << ", style " << style << (embed ? ", embedded map: " : ": ")
+                  << sink.output.size() << " bytes in " << sink.chunks << " writes" << std::endl;
+      }
+    }
+  }
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+// compiles files through a compiler pool, which shares parsed imports,
+// and compares each result with a plain compilation of the same file
+// g++ -Iinclude test/test_parse_cache.cpp lib/libsass.a -ldl -lpthread -o parse_cache
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include "sass/context.h"
+
+std::string dir;
+
+void write(const std::string& path, const std::string& content, time_t mtime)
+{
+  std::ofstream(dir + "/" + path) << content;
+  struct utimbuf times = { mtime, mtime };
+  utime((dir + "/" + path).c_str(), &times);
+}
+
+std::string result(int status, struct Sass_Context* ctx)
+{
+  return status ? sass_context_get_error_message(ctx) : sass_context_get_output_string(ctx);
+}
+
+std::string compile(struct Sass_Compiler_Pool* pool, const std::string& file, const std::string& include_path)
+{
+  struct Sass_File_Context* file_ctx = sass_make_file_context((dir + "/" + file).c_str());
+  struct Sass_Context* ctx = sass_file_context_get_context(file_ctx);
+  struct Sass_Options* options = sass_context_get_options(ctx);
+  sass_option_set_output_style(options, SASS_STYLE_COMPRESSED);
+  if (!include_path.empty()) sass_option_set_include_path(options, (dir + "/" + include_path).c_str());
+  int status = pool ? sass_compiler_pool_compile_file(pool, file_ctx) : sass_compile_file_context(file_ctx);
+  std::string css(result(status, ctx));
+  sass_delete_file_context(file_ctx);
+  return css;
+}
+
+int check(struct Sass_Compiler_Pool* pool, const std::string& what, const std::string& file, const std::string& include_path = "")
+{
+  std::string expected(compile(0, file, include_path));
+  std::string actual(compile(pool, file, include_path));
+  if (actual == expected) return 0;
+  std::cout << what << ": expected " << expected << " but got " << actual << std::endl;
+  return 1;
+}
+
+int main()
+{
+  char tmpl[] = "/tmp/parse_cache_XXXXXX";
+  if (!mkdtemp(tmpl)) return 1;
+  dir = tmpl;
+  mkdir((dir + "/a").c_str(), 0755);
+  mkdir((dir + "/b").c_str(), 0755);
+
+  int failures = 0;
+  struct Sass_Compiler_Pool* pool = sass_make_compiler_pool(sass_make_options());
+
+  // evaluation must not change the shared tree
+  write("_part.scss", "$x: foo; $y: null;\n.a { b: -$x; c: -$y; d: 10px/8px; e: +$x; }\n", 1000);
+  write("main.scss", "@import 'part';\n.m { n: -$x; }\n", 1000);
+  for (int i = 0; i < 3; ++i) failures += check(pool, "reuse", "main.scss");
+
+  // changed imports are parsed again
+  write("_part.scss", "$x: bar; .a { b: $x; }\n", 1000);
+  failures += check(pool, "size changed", "main.scss");
+  write("_part.scss", "$x: baz; .a { b: $x; }\n", 2000);
+  failures += check(pool, "mtime changed", "main.scss");
+
+  // imports are resolved with the include paths of each compile
+  write("a/_lib.scss", ".x { v: a; }\n", 1000);
+  write("b/_lib.scss", ".x { v: b; }\n", 1000);
+  write("_mid.scss", "@import 'lib';\n", 1000);
+  write("paths.scss", "@import 'mid';\n", 1000);
+  for (int i = 0; i < 4; ++i) failures += check(pool, "include path", "paths.scss", i % 2 ? "b" : "a");
+
+  // a new file that takes precedence over the include path
+  write("_lib.scss", ".x { v: local; }\n", 1000);
+  failures += check(pool, "new file", "paths.scss", "a");
+  remove((dir + "/_lib.scss").c_str());
+  failures += check(pool, "removed file", "paths.scss", "a");
+
+  sass_delete_compiler_pool(pool);
+
+  const char* files[] = { "_part.scss", "main.scss", "a/_lib.scss", "b/_lib.scss", "_mid.scss", "paths.scss", "a", "b", "" };
+  for (const char** file = files; **file; ++file) remove((dir + "/" + *file).c_str());
+  remove(dir.c_str());
+
+  std::cout << failures << " failures" << std::endl;
+  return failures ? 1 : 0;
+}
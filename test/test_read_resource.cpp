@@ -0,0 +1,65 @@
+// compares read_resource against read_file for files around the size
+// where they get mapped and around page boundaries; exits with 1 on any
+// mismatch (test/bench.cpp measures both on a huge file)
+// g++ -std=c++11 -O2 -Isrc -Iinclude test/test_read_resource.cpp lib/libsass.a -ldl -o read_resource
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <unistd.h>
+#include "sass.hpp"
+#include "file.hpp"
+
+using namespace Sass;
+
+std::string write_file(const std::string& path, size_t size)
+{
+  std::string content;
+  while (content.size() < size) content += ".rule { color: red; } // comment\n";
+  content.resize(size);
+  std::ofstream file(path.c_str(), std::ios::binary);
+  file << content;
+  return content;
+}
+
+// returns the number of mismatches
+size_t check(const std::string& path)
+{
+  size_t page = sysconf(_SC_PAGESIZE);
+  std::vector<size_t> sizes;
+  for (size_t base : { size_t(0), size_t(100), 64 * page, 65 * page, 1024 * page }) {
+    for (size_t delta : { 0, 1, 2 }) {
+      sizes.push_back(base + delta);
+      if (base > delta) sizes.push_back(base - delta);
+    }
+  }
+
+  size_t mismatches = 0, mapped = 0;
+  for (size_t size : sizes) {
+    std::string content(write_file(path, size));
+    char* contents = File::read_file(path);
+    Resource res(File::read_resource(path));
+    if (res.mapped) ++ mapped;
+    if (!contents || !res.contents ||
+        std::strlen(res.contents) != size || std::memcmp(res.contents, content.data(), size) != 0 ||
+        std::strcmp(contents, res.contents) != 0) {
+      if (mismatches ++ == 0) std::cout << "mismatch for " << size << " bytes" << std::endl;
+    }
+    free(contents);
+    File::free_resource(res);
+  }
+  Resource missing(File::read_resource(path + ".missing"));
+  if (missing.contents != 0 && mismatches ++ == 0) std::cout << "read a missing file" << std::endl;
+  std::cout << sizes.size() << " files, " << mapped << " mapped, " << mismatches << " mismatches" << std::endl;
+  return mismatches;
+}
+
+int main()
+{
+  std::string path("read_resource.scss");
+  size_t mismatches = check(path);
+  unlink(path.c_str());
+  return mismatches ? 1 : 0;
+}
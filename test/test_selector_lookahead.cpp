@@ -0,0 +1,44 @@
+// checks that re_simple_selector_list stops at the same position
+// as the full re_selector_list when the parser uses its result;
+// prints the first mismatch and exits with 1 if there is any
+// g++ -std=c++11 -Isrc -Iinclude test/test_selector_lookahead.cpp lib/libsass.a -ldl -lpthread -o selector_lookahead
+#include <string>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include "prelexer.hpp"
+
+using namespace Sass::Prelexer;
+
+// bytes (and pairs) selectors and their neighbours are made of
+// the first ones are the only ones a plain selector may contain
+const size_t plain_pieces = 24;
+const char* pieces[] = {
+  "a", "b", "z", "A", "1", "5", "n", "e", "-", "--", "_", ".", "#", "%", "&",
+  ":", "::", ">", "+", "~", ",", "*", " ", "\n", "\t", "{", "(", ")", "[", "]",
+  "=", "/", "//", "@", "$", "!", "\"", "'", "|", "#{", "}", ";", "\\", "\xC3\xA9"
+};
+
+int main()
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<size_t> any_piece(0, sizeof(pieces) / sizeof(pieces[0]) - 1);
+  std::uniform_int_distribution<size_t> plain_piece(0, plain_pieces - 1);
+  std::uniform_int_distribution<size_t> length(1, 16);
+  size_t plain = 0, mismatches = 0;
+  for (size_t i = 0; i < 5000000; ++i) {
+    std::string src;
+    for (size_t n = length(rng); n > 0; --n) {
+      src += pieces[i % 2 ? plain_piece(rng) : any_piece(rng)];
+    }
+    src += "{";
+    const char* q = re_simple_selector_list(src.c_str());
+    if (!q || !std::strchr("{:;}", *q)) continue;
+    ++ plain;
+    if (re_selector_list(src.c_str()) != q && mismatches ++ == 0) {
+      std::cout << "mismatch for \"" << src << "\"" << std::endl;
+    }
+  }
+  std::cout << plain << " plain selectors or declarations, " << mismatches << " mismatches" << std::endl;
+  return plain > 0 && mismatches == 0 ? 0 : 1;
+}
@@ -1,13 +1,21 @@
+// ported ruby tests for the subset map and checks of keys that
+// repeat within a set; exits with 1 if any check fails
+// g++ -std=c++11 -Isrc test/test_subset_map.cpp -o subset_map
 #include <string>
+#include <sstream>
 #include <iostream>
-#include <assert.h>
-#include "../subset_map.hpp"
+#include "subset_map.hpp"
+
+using namespace Sass;
 
 Subset_Map<std::string, std::string> ssm;
 
-string toString(std::vector<std::string> v);
-string toString(std::vector<std::pair<std::string, std::vector<std::string>>> v);
-void assertEqual(string std::sExpected, std::string sResult);
+std::string toString(std::vector<std::string> v);
+std::string toString(std::vector<std::pair<std::string, std::vector<std::string>>> v);
+void assertEqual(std::string sExpected, std::string sResult);
+
+// number of failed checks
+size_t failures = 0;
 
 void setup() {
   ssm.clear();
@@ -343,6 +351,34 @@ void testMultipleEqualValues() {
   std::cout << std::endl;
 }
 
+// keys are interned, so a key may only count once per set
+void testRepeatedKeys() {
+  std::cout << "testRepeatedKeys" << std::endl;
+  std::vector<std::string> s1;
+  s1.push_back("a");
+  s1.push_back("b");
+  s1.push_back("a");
+  ssm.put(s1, "Rep");
+
+  std::vector<std::string> k1;
+  k1.push_back("b");
+  k1.push_back("a");
+  assertEqual("[[Rep, Set[a, b, a]]]", toString(ssm.get_kv(k1)));
+
+  std::vector<std::string> k2;
+  k2.push_back("a");
+  k2.push_back("a");
+  assertEqual("[]", toString(ssm.get_kv(k2)));
+
+  std::vector<std::string> k3;
+  k3.push_back("2");
+  k3.push_back("1");
+  k3.push_back("2");
+  assertEqual("[[Foo, Set[1, 2]]]", toString(ssm.get_kv(k3)));
+
+  std::cout << std::endl;
+}
+
 int main()
 {
   std::vector<std::string> s1;
@@ -366,19 +402,19 @@ int main()
   s4.push_back("2");
   s4.push_back("3");
   
-  std::vector<std::pair<string, std::vector<std::string> > > fetched(ssm.get_kv(s4));
+  std::vector<std::pair<std::string, std::vector<std::string> > > fetched(ssm.get_kv(s4));
   
   std::cout << "PRINTING RESULTS:" << std::endl;
   for (size_t i = 0, S = fetched.size(); i < S; ++i) {
     std::cout << fetched[i].first << std::endl;
   }
   
-  Subset_Map<string, string> ssm2;
+  Subset_Map<std::string, std::string> ssm2;
   ssm2.put(s1, "foo");
   ssm2.put(s2, "bar");
   ssm2.put(s4, "hux");
   
-  std::vector<std::pair<string, std::vector<std::string> > > fetched2(ssm2.get_kv(s4));
+  std::vector<std::pair<std::string, std::vector<std::string> > > fetched2(ssm2.get_kv(s4));
   
   std::cout << std::endl << "PRINTING RESULTS:" << std::endl;
   for (size_t i = 0, S = fetched2.size(); i < S; ++i) {
@@ -387,7 +423,7 @@ int main()
   
   std::cout << "TRYING ON A SELECTOR-LIKE OBJECT" << std::endl;
   
-  Subset_Map<string, string> sel_ssm;
+  Subset_Map<std::string, std::string> sel_ssm;
   std::vector<std::string> target;
   target.push_back("desk");
   target.push_back(".wood");
@@ -398,7 +434,7 @@ int main()
   actual.push_back(".mine");
   
   sel_ssm.put(target, "has-aquarium");
-  std::vector<std::pair<string, std::vector<std::string> > > fetched3(sel_ssm.get_kv(actual));
+  std::vector<std::pair<std::string, std::vector<std::string> > > fetched3(sel_ssm.get_kv(actual));
   std::cout << "RESULTS:" << std::endl;
   for (size_t i = 0, S = fetched3.size(); i < S; ++i) {
     std::cout << fetched3[i].first << std::endl;
@@ -425,11 +461,15 @@ int main()
   
   setup();
   testMultipleEqualValues();
-  
-  return 0;
+
+  setup();
+  testRepeatedKeys();
+
+  std::cout << failures << " failures" << std::endl;
+  return failures ? 1 : 0;
 }
 
-string toString(std::vector<std::pair<string, std::vector<std::string>>> v)
+std::string toString(std::vector<std::pair<std::string, std::vector<std::string>>> v)
 {
   std::stringstream buffer;
   buffer << "[";
@@ -451,7 +491,7 @@ string toString(std::vector<std::pair<string, std::vector<std::string>>> v)
   return buffer.str();
 }
 
-string toString(std::vector<std::string> v)
+std::string toString(std::vector<std::string> v)
 {
   std::stringstream buffer;
   buffer << "[";
@@ -465,8 +505,8 @@ string toString(std::vector<std::string> v)
   return buffer.str();
 }
 
-void assertEqual(string sExpected, string sResult) {
+void assertEqual(std::string sExpected, std::string sResult) {
   std::cout << "Expected: " << sExpected << std::endl;
   std::cout << "Result:   " << sResult << std::endl;
-  assert(sExpected == sResult);
+  if (sExpected != sResult) ++ failures;
 }
@@ -0,0 +1,65 @@
+// spec style cases for arithmetic on numbers with units
+// units of different classes do not convert into each other
+// prints every mismatch and exits with 1 if there is any
+// g++ -Iinclude test/test_unit_conversion.cpp lib/libsass.a -ldl -o unit_conversion
+#include <string>
+#include <iostream>
+#include "sass/context.h"
+
+struct Spec {
+  const char* value;
+  // expected output or error text
+  const char* expected;
+  bool error;
+};
+
+const Spec specs[] = {
+  // units of the same class convert
+  { "(2in/1px)", "192", false },
+  { "(1turn/1deg)", "360", false },
+  { "(1px*1deg/1rad)", "0.01745px", false },
+  { "(1s*1px/1ms)", "1000px", false },
+  { "comparable(1px, 1in)", "true", false },
+  { "comparable(1s, 1ms)", "true", false },
+  // units of different classes stay
+  { "unit(1px/1s)", "\"px/s\"", false },
+  { "unit(1deg*1px)", "\"deg*px\"", false },
+  { "comparable(1px, 1deg)", "false", false },
+  { "comparable(1s, 1px)", "false", false },
+  { "(10px/1deg)", "10px/deg isn't a valid CSS value.", true },
+  { "(3px*2/1s)", "6px/s isn't a valid CSS value.", true },
+  { "(1in/1dppx)", "1in/dppx isn't a valid CSS value.", true },
+  { "1px < 1s", "cannot compare numbers with incompatible units", true },
+  { "(1px + 1deg)", "Incompatible units: 'deg' and 'px'", true },
+  // but the units of one class in there still convert
+  { "3px*2ms/4pt", "1.125ms", false },
+  { "3in*2Hz/4pt", "108Hz", false },
+  // custom units only convert to themself
+  { "(4em*2px/2em)", "4px", false },
+  { "comparable(1px, 1em)", "false", false },
+};
+
+int main()
+{
+  size_t failures = 0;
+  for (const Spec& spec : specs) {
+    std::string scss = std::string("a { b: ") + spec.value + "; }";
+    struct Sass_Data_Context* data_ctx = sass_make_data_context(sass_copy_c_string(scss.c_str()));
+    struct Sass_Context* ctx = sass_data_context_get_context(data_ctx);
+    sass_option_set_output_style(sass_context_get_options(ctx), SASS_STYLE_COMPACT);
+    int status = sass_compile_data_context(data_ctx);
+
+    std::string expected(spec.error ? spec.expected : std::string("a { b: ") + spec.expected + "; }\n");
+    std::string actual(status ? sass_context_get_error_text(ctx) : sass_context_get_output_string(ctx));
+    if (status != spec.error) actual = (status ? "error " : "output ") + actual;
+
+    if (actual != expected) {
+      std::cout << spec.value << ": expected \"" << expected
+                << "\" but got \"" << actual << "\"" << std::endl;
+      ++ failures;
+    }
+    sass_delete_data_context(data_ctx);
+  }
+  std::cout << (sizeof(specs) / sizeof(specs[0])) << " specs, " << failures << " failures" << std::endl;
+  return failures ? 1 : 0;
+}